@@ -16,14 +16,18 @@
 
 
 #include <iostream>
+#include <algorithm>
 #include "allocator.h"
 
 
 
 template <typename T>
-Allocator<T>::Allocator(const int dim, const int tabSize): currentId(-1), dim(dim), tabSize(tabSize)
+Allocator<T>::Allocator(const int dim, const int tabSize, MemoryResource* resource):
+currentId(-1), dim(dim), tabSize(tabSize),
+maxTabSize(std::max<int>(tabSize, ALLOCATOR_MAX_PAGE_BYTES / (sizeof(T) * (dim > 0 ? dim : 1)))),
+resource(resource)
 {
-    currentTab = new T[dim * tabSize];
+    currentTab = resource_new<T>(resource, static_cast<size_t>(dim) * tabSize);
 }
 
 template <typename T>
@@ -31,17 +35,29 @@ Allocator<T>::~Allocator()
 {
     for(unsigned int i = 0; i < prevTabs.size(); ++i)
     {
-        delete [] prevTabs[i];
+        resource_delete(resource, prevTabs[i].first, static_cast<size_t>(dim) * prevTabs[i].second);
     }
 
-    delete [] currentTab;
+    resource_delete(resource, currentTab, static_cast<size_t>(dim) * tabSize);
 }
 
 template <typename T>
 void Allocator<T>::shiftTables()
 {
-    prevTabs.push_back(currentTab);
-    currentTab      = new T[dim * tabSize];
+    const int newSize = next_page_size(tabSize, maxTabSize);
+
+    // If the resource throws (e.g. a MemoryBudget), the allocator stays as it was
+    prevTabs.push_back(std::make_pair(currentTab, tabSize));
+    try
+    {
+        currentTab  = resource_new<T>(resource, static_cast<size_t>(dim) * newSize);
+    }
+    catch(...)
+    {
+        prevTabs.pop_back();
+        throw;
+    }
+    tabSize         = newSize;
     currentId       = 0;
 }
 
@@ -19,9 +19,11 @@
 #define ALLOCATOR_HPP
 
 #include <vector>
+#include <utility>
 #include <iostream>
 #include <string.h>
 #include "conf.h"
+#include "arena.h"
 
 
 template <typename T> inline void copyConf(
@@ -31,14 +33,28 @@ template <typename T> inline void copyConf(
     memcpy(destination, source, dim*sizeof(T));
 }
 
+// Pages start at tabSize configurations and double from one to the next, up to
+// ALLOCATOR_MAX_PAGE_BYTES (or tabSize, if that's more): small jobs don't take
+// much, and big ones don't need many pages.
+#define ALLOCATOR_MAX_PAGE_BYTES (1024*1024)
+
+// Size of the page that comes after one of size tabSize
+inline int next_page_size(int tabSize, int maxTabSize)
+{
+    return tabSize >= maxTabSize / 2 ? maxTabSize : tabSize * 2;
+}
+
 template <typename T> class Allocator{
 private:
     T*      currentTab;
     int currentId;
-    const int       dim, tabSize;
-    std::vector<T*>  prevTabs;
+    const int       dim;
+    int     tabSize;                            // of the current page
+    const int       maxTabSize;
+    std::vector<std::pair<T*, int> >  prevTabs;  // with their sizes
+    MemoryResource* const resource;
 public:
-    Allocator(const int dim, const int tabSize = 10000);
+    Allocator(const int dim, const int tabSize = 10000, MemoryResource* resource = default_memory_resource());
     ~Allocator();
 
     void shiftTables();
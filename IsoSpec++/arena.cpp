@@ -0,0 +1,246 @@
+/*
+ *   Copyright (C) 2015-2016 Mateusz Łącki and Michał Startek.
+ *
+ *   This file is part of IsoSpec.
+ *
+ *   IsoSpec is free software: you can redistribute it and/or modify
+ *   it under the terms of the Simplified ("2-clause") BSD licence.
+ *
+ *   IsoSpec is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *   You should have received a copy of the Simplified BSD Licence
+ *   along with IsoSpec.  If not, see <https://opensource.org/licenses/BSD-2-Clause>.
+ */
+
+
+#include <stdint.h>
+#include "arena.h"
+#include "isoMath.h"
+
+#ifdef __MINGW32__
+	#include "mman.h"
+#else
+	#include <sys/mman.h>
+#endif
+
+
+class NewDeleteResource : public MemoryResource
+{
+public:
+    void* allocate(size_t bytes, size_t) override { return ::operator new(bytes); }
+    void deallocate(void* p, size_t, size_t) override { ::operator delete(p); }
+};
+
+MemoryResource* default_memory_resource()
+{
+    static NewDeleteResource resource;
+    return &resource;
+}
+
+
+Arena::Arena(size_t initial_size, MemoryResource* _upstream) :
+upstream(_upstream),
+blocks(nullptr),
+current(nullptr),
+end(nullptr),
+next_block_size(initial_size < 1024 ? 1024 : initial_size)
+{}
+
+Arena::~Arena()
+{
+    while(blocks != nullptr)
+    {
+        Block* next = blocks->next;
+        upstream->deallocate(blocks, blocks->size, alignof(Block));
+        blocks = next;
+    }
+}
+
+void Arena::new_block(size_t min_size)
+{
+    size_t size = next_block_size;
+    while(size < min_size + sizeof(Block) + alignof(max_align_t))
+        size *= 2;
+    next_block_size = size * 2;
+
+    Block* block = static_cast<Block*>(upstream->allocate(size, alignof(Block)));
+    block->next = blocks;
+    block->size = size;
+    blocks = block;
+    current = reinterpret_cast<char*>(block + 1);
+    end = reinterpret_cast<char*>(block) + size;
+}
+
+void* Arena::allocate(size_t bytes, size_t alignment)
+{
+    uintptr_t p = (reinterpret_cast<uintptr_t>(current) + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    if(current == nullptr or p + bytes > reinterpret_cast<uintptr_t>(end))
+    {
+        new_block(bytes + alignment);
+        p = (reinterpret_cast<uintptr_t>(current) + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    }
+    current = reinterpret_cast<char*>(p + bytes);
+    return reinterpret_cast<void*>(p);
+}
+
+void Arena::reset()
+{
+    if(blocks == nullptr)
+        return;
+
+    // Blocks grow, so the current one is the largest: it should be enough next time
+    while(blocks->next != nullptr)
+    {
+        Block* next = blocks->next;
+        blocks->next = next->next;
+        upstream->deallocate(next, next->size, alignof(Block));
+    }
+    current = reinterpret_cast<char*>(blocks + 1);
+    end = reinterpret_cast<char*>(blocks) + blocks->size;
+}
+
+
+MemoryBudget::MemoryBudget(size_t _limit, MemoryResource* _upstream) :
+upstream(_upstream),
+limit(_limit),
+used(0),
+_exceeded(false)
+{}
+
+void* MemoryBudget::allocate(size_t bytes, size_t alignment)
+{
+    const size_t before = used.fetch_add(bytes, std::memory_order_relaxed);
+    if(before + bytes > limit or before + bytes < before)
+    {
+        used.fetch_sub(bytes, std::memory_order_relaxed);
+        _exceeded.store(true, std::memory_order_relaxed);
+        throw MemoryBudgetExceeded();
+    }
+
+    try
+    {
+        return upstream->allocate(bytes, alignment);
+    }
+    catch(...)
+    {
+        used.fetch_sub(bytes, std::memory_order_relaxed);
+        throw;
+    }
+}
+
+void MemoryBudget::deallocate(void* p, size_t bytes, size_t alignment)
+{
+    upstream->deallocate(p, bytes, alignment);
+    used.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+
+static std::atomic<bool> huge_pages_enabled(false);
+
+static inline void advise_huge_pages(void* p, size_t bytes)
+{
+#ifdef MADV_HUGEPAGE
+    madvise(p, bytes, MADV_HUGEPAGE);
+#else
+    (void) p;
+    (void) bytes;
+#endif
+}
+
+void set_huge_pages(bool enabled)
+{
+    huge_pages_enabled.store(enabled, std::memory_order_relaxed);
+    // The factorial table is mapped at startup; only the pages of it touched
+    // from now on get huge
+    if(enabled)
+        advise_huge_pages(g_lfact_table, sizeof(double)*G_FACT_TABLE_SIZE);
+}
+
+bool huge_pages()
+{
+    return huge_pages_enabled.load(std::memory_order_relaxed);
+}
+
+static inline void* map_anonymous(size_t bytes)
+{
+    void* ret = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if(ret == MAP_FAILED)
+        throw std::bad_alloc();
+    return ret;
+}
+
+void* map_pages(size_t bytes)
+{
+    void* ret = map_anonymous(bytes);
+    if(huge_pages())
+        advise_huge_pages(ret, bytes);
+    return ret;
+}
+
+void unmap_pages(void* p, size_t bytes)
+{
+    munmap(p, bytes);
+}
+
+
+HugePageResource::HugePageResource(size_t _min_bytes, MemoryResource* _upstream) :
+upstream(_upstream),
+min_bytes(_min_bytes)
+{}
+
+void* HugePageResource::allocate(size_t bytes, size_t alignment)
+{
+    if(bytes < min_bytes)
+        return upstream->allocate(bytes, alignment);
+    // Mappings are page-aligned, which is plenty for anything
+    void* ret = map_anonymous(bytes);
+    advise_huge_pages(ret, bytes);
+    return ret;
+}
+
+void HugePageResource::deallocate(void* p, size_t bytes, size_t alignment)
+{
+    if(bytes < min_bytes)
+        upstream->deallocate(p, bytes, alignment);
+    else
+        munmap(p, bytes);
+}
+
+MemoryResource* huge_page_resource()
+{
+    static HugePageResource resource;
+    return &resource;
+}
+
+MemoryAccounting::MemoryAccounting(MemoryResource* _upstream) :
+upstream(_upstream),
+total_used(0),
+total_peak(0)
+{
+    for(int c=0; c<MEMORY_COMPONENTS_NO; c++)
+    {
+        accounts[c].owner = this;
+        accounts[c].used = accounts[c].peak = 0;
+    }
+}
+
+void* MemoryAccounting::Account::allocate(size_t bytes, size_t alignment)
+{
+    void* ret = owner->upstream->allocate(bytes, alignment);
+    used += bytes;
+    if(used > peak)
+        peak = used;
+    owner->total_used += bytes;
+    if(owner->total_used > owner->total_peak)
+        owner->total_peak = owner->total_used;
+    return ret;
+}
+
+void MemoryAccounting::Account::deallocate(void* p, size_t bytes, size_t alignment)
+{
+    owner->upstream->deallocate(p, bytes, alignment);
+    used -= bytes;
+    owner->total_used -= bytes;
+}
@@ -0,0 +1,276 @@
+/*
+ *   Copyright (C) 2015-2016 Mateusz Łącki and Michał Startek.
+ *
+ *   This file is part of IsoSpec.
+ *
+ *   IsoSpec is free software: you can redistribute it and/or modify
+ *   it under the terms of the Simplified ("2-clause") BSD licence.
+ *
+ *   IsoSpec is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *   You should have received a copy of the Simplified BSD Licence
+ *   along with IsoSpec.  If not, see <https://opensource.org/licenses/BSD-2-Clause>.
+ */
+
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <new>
+#include <utility>
+#include <atomic>
+#include <vector>
+
+// Parts of an Iso and its generator whose memory is accounted for separately
+enum MemoryComponent
+{
+    MEMORY_ISO,             // the Iso's own tables, and anything not listed below
+    MEMORY_MARGINALS,       // configurations of the marginals, their masses and probabilities
+    MEMORY_CONF_PAGES,      // pages of Allocator and DirtyAllocator
+    MEMORY_HASH_TABLES,     // sets of configurations already visited
+    MEMORY_QUEUES,          // priority queues of the ordered generator and of the marginals
+    MEMORY_GENERATOR,       // the state of the generator itself
+    MEMORY_COMPONENTS_NO,
+    MEMORY_TOTAL = MEMORY_COMPONENTS_NO
+};
+
+/*
+ * Where an Iso, its marginals and its generator get their memory from: a stand-in
+ * for std::pmr::memory_resource, which needs C++17. Arrays, objects built with
+ * resource_construct and containers with a ResourceAllocator come from here.
+ * Each component allocates from component(c), which is the resource itself
+ * unless it keeps accounts (see MemoryAccounting).
+ */
+class MemoryResource
+{
+public:
+    virtual void* allocate(size_t bytes, size_t alignment) = 0;
+    virtual void deallocate(void* p, size_t bytes, size_t alignment) = 0;
+    virtual MemoryResource* component(MemoryComponent) { return this; };
+    virtual ~MemoryResource() {}
+};
+
+// Plain operator new and delete, used when no resource is given
+MemoryResource* default_memory_resource();
+
+/*
+ * Monotonic arena: allocations are carved out of blocks taken from upstream, one
+ * after another, and deallocate does nothing. reset() makes all the memory
+ * available again at once, keeping the largest block, so that a worker can go
+ * through molecule after molecule without calling malloc: everything allocated
+ * from the arena has to be destroyed before that. Not thread-safe.
+ */
+class Arena : public MemoryResource
+{
+private:
+    struct Block
+    {
+        Block* next;
+        size_t size;
+    };
+
+    MemoryResource* const upstream;
+    Block* blocks;              // the current one first
+    char* current;
+    char* end;
+    size_t next_block_size;
+
+    void new_block(size_t min_size);
+
+public:
+    Arena(size_t initial_size = 64*1024, MemoryResource* upstream = default_memory_resource());
+    Arena(const Arena& other) = delete;
+    Arena& operator=(const Arena& other) = delete;
+    ~Arena();
+
+    void* allocate(size_t bytes, size_t alignment) override;
+    inline void deallocate(void*, size_t, size_t) override {};
+    void reset();
+};
+
+/*
+ * Passes allocations on to upstream for as long as the bytes in use stay within
+ * the limit, and throws MemoryBudgetExceeded (a std::bad_alloc) past it. Given to
+ * an Iso, it caps what the Iso and its generator take: constructors throw, while
+ * the ordered and layered generators, which allocate as they go, just stop as if
+ * they ran out of configurations; exceeded() tells these cases apart. Thread-safe,
+ * so that a budget may be shared (also as the upstream of per-thread arenas).
+ */
+class MemoryBudgetExceeded : public std::bad_alloc
+{
+public:
+    const char* what() const noexcept override { return "Memory budget exceeded"; }
+};
+
+class MemoryBudget : public MemoryResource
+{
+private:
+    MemoryResource* const upstream;
+    const size_t limit;
+    std::atomic<size_t> used;
+    std::atomic<bool> _exceeded;
+
+public:
+    MemoryBudget(size_t limit, MemoryResource* upstream = default_memory_resource());
+    MemoryBudget(const MemoryBudget& other) = delete;
+    MemoryBudget& operator=(const MemoryBudget& other) = delete;
+
+    void* allocate(size_t bytes, size_t alignment) override;
+    void deallocate(void* p, size_t bytes, size_t alignment) override;
+
+    inline size_t get_limit() const { return limit; };
+    inline size_t get_used() const { return used.load(std::memory_order_relaxed); };
+    inline bool exceeded() const { return _exceeded.load(std::memory_order_relaxed); };
+};
+
+/*
+ * Large tables (histograms of Spectrum, the log-factorial table, and with
+ * huge_page_resource the big tables of the marginals) are mapped straight from
+ * the system, in whole pages. With huge pages on, they are advised to be backed by
+ * transparent huge pages (madvise(MADV_HUGEPAGE), where the platform has it),
+ * which saves TLB misses on tables of megabytes. Off by default: a huge page is
+ * resident as a whole as soon as any of it is touched. Pages are only backed when
+ * first written to, so the NUMA node of the thread doing that holds them.
+ */
+#define HUGE_PAGE_BYTES (2*1024*1024)
+
+void set_huge_pages(bool enabled);
+bool huge_pages();
+
+// Zeroed; throws std::bad_alloc if the system has no memory to map
+void* map_pages(size_t bytes);
+void unmap_pages(void* p, size_t bytes);
+
+// Allocations of at least min_bytes go to map_pages, the rest to upstream.
+// Given to an Iso, or used by Iso itself when none is given and huge pages are on.
+class HugePageResource : public MemoryResource
+{
+private:
+    MemoryResource* const upstream;
+    const size_t min_bytes;
+
+public:
+    HugePageResource(size_t min_bytes = HUGE_PAGE_BYTES, MemoryResource* upstream = default_memory_resource());
+
+    void* allocate(size_t bytes, size_t alignment) override;
+    void deallocate(void* p, size_t bytes, size_t alignment) override;
+};
+
+MemoryResource* huge_page_resource();
+
+/*
+ * Bytes in use, and their peak, per component: allocations from component(c)
+ * are counted for c, and those made directly count as MEMORY_ISO. Everything is
+ * passed on to upstream. Every Iso keeps one (see Iso::memory_used), which costs
+ * a few additions per allocation. Not thread-safe, like the Iso itself.
+ */
+class MemoryAccounting : public MemoryResource
+{
+private:
+    class Account : public MemoryResource
+    {
+    public:
+        MemoryAccounting* owner;
+        size_t used;
+        size_t peak;
+
+        void* allocate(size_t bytes, size_t alignment) override;
+        void deallocate(void* p, size_t bytes, size_t alignment) override;
+        inline MemoryResource* component(MemoryComponent c) override { return owner->component(c); };
+    };
+
+    MemoryResource* const upstream;
+    Account accounts[MEMORY_COMPONENTS_NO];
+    size_t total_used;
+    size_t total_peak;
+
+public:
+    MemoryAccounting(MemoryResource* upstream = default_memory_resource());
+    MemoryAccounting(const MemoryAccounting& other) = delete;
+    MemoryAccounting& operator=(const MemoryAccounting& other) = delete;
+
+    inline void* allocate(size_t bytes, size_t alignment) override { return accounts[MEMORY_ISO].allocate(bytes, alignment); };
+    inline void deallocate(void* p, size_t bytes, size_t alignment) override { accounts[MEMORY_ISO].deallocate(p, bytes, alignment); };
+    inline MemoryResource* component(MemoryComponent c) override { return &accounts[c]; };
+
+    // Of all the components together for MEMORY_TOTAL (whose peak is that of the
+    // sum, not the sum of the peaks)
+    inline size_t used(MemoryComponent c) const { return c == MEMORY_TOTAL ? total_used : accounts[c].used; };
+    inline size_t peak(MemoryComponent c) const { return c == MEMORY_TOTAL ? total_peak : accounts[c].peak; };
+    inline MemoryResource* get_upstream() const { return upstream; };
+};
+
+template<typename T> inline T* resource_new(MemoryResource* resource, size_t size)
+{
+    return static_cast<T*>(resource->allocate(size*sizeof(T), alignof(T)));
+}
+
+template<typename T> inline void resource_delete(MemoryResource* resource, T* p, size_t size)
+{
+    if(p != nullptr)
+        resource->deallocate(const_cast<void*>(static_cast<const void*>(p)), size*sizeof(T), alignof(T));
+}
+
+template<typename T> inline T* resource_copy(MemoryResource* resource, const T* A, size_t size)
+{
+    T* ret = resource_new<T>(resource, size);
+    for(size_t ii=0; ii<size; ii++)
+        ret[ii] = A[ii];
+    return ret;
+}
+
+template<typename T, typename... Args> inline T* resource_construct(MemoryResource* resource, Args&&... args)
+{
+    void* p = resource->allocate(sizeof(T), alignof(T));
+    try
+    {
+        return new (p) T(std::forward<Args>(args)...);
+    }
+    catch(...)
+    {
+        resource->deallocate(p, sizeof(T), alignof(T));
+        throw;
+    }
+}
+
+template<typename T> inline void resource_destroy(MemoryResource* resource, T* p)
+{
+    if(p != nullptr)
+    {
+        p->~T();
+        resource->deallocate(p, sizeof(T), alignof(T));
+    }
+}
+
+// For standard containers, which then take their memory from the resource too
+template<typename T> class ResourceAllocator
+{
+public:
+    typedef T value_type;
+
+    MemoryResource* resource;
+
+    ResourceAllocator() : resource(default_memory_resource()) {}
+    ResourceAllocator(MemoryResource* _resource) : resource(_resource) {}
+    template<typename U> ResourceAllocator(const ResourceAllocator<U>& other) : resource(other.resource) {}
+
+    inline T* allocate(size_t n) { return resource_new<T>(resource, n); };
+    inline void deallocate(T* p, size_t n) { resource_delete(resource, p, n); };
+};
+
+template<typename T, typename U> inline bool operator==(const ResourceAllocator<T>& a, const ResourceAllocator<U>& b)
+{
+    return a.resource == b.resource;
+}
+
+template<typename T, typename U> inline bool operator!=(const ResourceAllocator<T>& a, const ResourceAllocator<U>& b)
+{
+    return a.resource != b.resource;
+}
+
+template<typename T> using resource_vector = std::vector<T, ResourceAllocator<T> >;
+
+#endif
@@ -0,0 +1,401 @@
+/*
+ *   Copyright (C) 2015-2016 Mateusz Łącki and Michał Startek.
+ *
+ *   This file is part of IsoSpec.
+ *
+ *   IsoSpec is free software: you can redistribute it and/or modify
+ *   it under the terms of the Simplified ("2-clause") BSD licence.
+ *
+ *   IsoSpec is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *   You should have received a copy of the Simplified BSD Licence
+ *   along with IsoSpec.  If not, see <https://opensource.org/licenses/BSD-2-Clause>.
+ */
+
+
+#include <string.h>
+#include <stdexcept>
+#include "arrowWriter.h"
+
+// Relevant bits of the Arrow format (Schema.fbs, Message.fbs, File.fbs)
+#define ARROW_METADATA_V5       4
+#define ARROW_HEADER_SCHEMA     1
+#define ARROW_HEADER_BATCH      3
+#define ARROW_TYPE_INT          2
+#define ARROW_TYPE_FLOAT        3
+#define ARROW_TYPE_FIXED_LIST   16
+#define ARROW_PRECISION_DOUBLE  2
+#define ARROW_CONTINUATION      0xFFFFFFFF
+#define ARROW_ALIGNMENT         64
+#define ARROW_MAGIC             "ARROW1"
+
+
+/*
+ * Minimal flatbuffer builder. Objects are written front to back, parents before
+ * their children, so that all the (unsigned, forward) offsets can be filled in
+ * with link() once the child is in place. Each vtable goes right before its table.
+ */
+class FlatBuffer
+{
+public:
+    struct Field
+    {
+        int      id;
+        int      size;      // 1, 2, 4 or 8 bytes; offsets are 4 byte fields set with link()
+        uint64_t value;
+    };
+
+    std::vector<uint8_t> data;
+
+    FlatBuffer() { put<uint32_t>(0); }    // offset of the root table
+
+    inline void pad_to(size_t alignment)
+    {
+        while(data.size() % alignment != 0)
+            data.push_back(0);
+    }
+
+    template<typename V> inline void set(size_t pos, V value)
+    {
+        memcpy(&data[pos], &value, sizeof(V));
+    }
+
+    template<typename V> inline size_t put(V value)
+    {
+        pad_to(sizeof(V));
+        const size_t pos = data.size();
+        data.resize(pos + sizeof(V));
+        set<V>(pos, value);
+        return pos;
+    }
+
+    inline void link(size_t pos, size_t target)
+    {
+        set<uint32_t>(pos, static_cast<uint32_t>(target - pos));
+    }
+
+    inline void set_root(size_t table) { link(0, table); }
+
+    // Returns the position of the table; positions of the fields go to field_pos
+    size_t table(const std::vector<Field>& fields, size_t* field_pos = nullptr)
+    {
+        int slots = 0;
+        for(const Field& f : fields)
+            if(f.id >= slots)
+                slots = f.id + 1;
+
+        // Fields go after the vtable offset, the largest first, each aligned to its size
+        std::vector<size_t> rel(fields.size());
+        size_t table_size = 4;
+        for(int size = 8; size > 0; size /= 2)
+            for(unsigned int ii = 0; ii < fields.size(); ii++)
+                if(fields[ii].size == size)
+                {
+                    table_size = (table_size + size - 1) / size * size;
+                    rel[ii] = table_size;
+                    table_size += size;
+                }
+
+        pad_to(2);
+        const size_t vtable = data.size();
+        data.resize(vtable + 4 + 2*slots, 0);
+        set<uint16_t>(vtable, 4 + 2*slots);
+        set<uint16_t>(vtable + 2, table_size);
+
+        pad_to(8);
+        const size_t table = data.size();
+        data.resize(table + table_size, 0);
+        set<int32_t>(table, static_cast<int32_t>(table - vtable));
+
+        for(unsigned int ii = 0; ii < fields.size(); ii++)
+        {
+            const size_t pos = table + rel[ii];
+            set<uint16_t>(vtable + 4 + 2*fields[ii].id, rel[ii]);
+            switch(fields[ii].size)
+            {
+                case 1: set<uint8_t>(pos, fields[ii].value); break;
+                case 2: set<uint16_t>(pos, fields[ii].value); break;
+                case 4: set<uint32_t>(pos, fields[ii].value); break;
+                case 8: set<uint64_t>(pos, fields[ii].value); break;
+            }
+            if(field_pos != nullptr)
+                field_pos[ii] = pos;
+        }
+        return table;
+    }
+
+    // Vector of count structs (or, with elems == nullptr, of count offsets to be linked)
+    size_t vector(const void* elems, size_t count, size_t elem_size, size_t alignment = 4)
+    {
+        pad_to(4);
+        while((data.size() + 4) % alignment != 0)
+            data.push_back(0);
+        const size_t pos = put<uint32_t>(count);
+        if(elems != nullptr)
+            data.insert(data.end(), reinterpret_cast<const uint8_t*>(elems), reinterpret_cast<const uint8_t*>(elems) + count*elem_size);
+        else
+            data.resize(data.size() + count*elem_size, 0);
+        return pos;
+    }
+
+    size_t string(const char* s)
+    {
+        const size_t len = strlen(s);
+        const size_t pos = put<uint32_t>(len);
+        data.insert(data.end(), s, s + len + 1);
+        return pos;
+    }
+};
+
+
+// A field of the schema, with its children (at most one, that's all we need)
+static size_t arrow_field(FlatBuffer& fb, const char* name, int type_type, const std::vector<FlatBuffer::Field>& type,
+                          const char* child_name = nullptr, int child_type_type = 0,
+                          const std::vector<FlatBuffer::Field>& child_type = std::vector<FlatBuffer::Field>())
+{
+    // name, type_type, type, children
+    size_t pos[4];
+    const size_t field = fb.table({{0, 4, 0}, {2, 1, static_cast<uint64_t>(type_type)}, {3, 4, 0}, {5, 4, 0}}, pos);
+
+    fb.link(pos[0], fb.string(name));
+    fb.link(pos[2], fb.table(type));
+
+    const size_t children = fb.vector(nullptr, child_name != nullptr ? 1 : 0, 4);
+    fb.link(pos[3], children);
+    if(child_name != nullptr)
+        fb.link(children + 4, arrow_field(fb, child_name, child_type_type, child_type));
+
+    return field;
+}
+
+static size_t arrow_schema(FlatBuffer& fb, const bool* columns, int allDim)
+{
+    static const char* names[3] = {"mass", "prob", "lprob"};
+
+    size_t fields_pos;
+    const size_t schema = fb.table({{1, 4, 0}}, &fields_pos);   // little endian is the default
+
+    const int no_fields = columns[0] + columns[1] + columns[2] + columns[3];
+    const size_t fields = fb.vector(nullptr, no_fields, 4);
+    fb.link(fields_pos, fields);
+
+    int idx = 0;
+    for(int ii = 0; ii < 3; ii++)
+        if(columns[ii])
+            fb.link(fields + 4 + 4*(idx++), arrow_field(fb, names[ii], ARROW_TYPE_FLOAT, {{0, 2, ARROW_PRECISION_DOUBLE}}));
+
+    if(columns[3])
+        fb.link(fields + 4 + 4*idx, arrow_field(fb, "conf", ARROW_TYPE_FIXED_LIST, {{0, 4, static_cast<uint64_t>(allDim)}},
+                                                "item", ARROW_TYPE_INT, {{0, 4, 32}, {1, 1, 1}}));
+    return schema;
+}
+
+// The message table, with its header left to link to the returned position
+static size_t arrow_message(FlatBuffer& fb, int header_type, uint64_t body_length)
+{
+    size_t pos[4];
+    fb.set_root(fb.table({{0, 2, ARROW_METADATA_V5}, {1, 1, static_cast<uint64_t>(header_type)}, {2, 4, 0}, {3, 8, body_length}}, pos));
+    return pos[2];
+}
+
+
+ArrowIPCWriter::ArrowIPCWriter(const char* path, int _allDim, bool _file_format,
+                     bool get_masses, bool get_probs,
+                     bool get_lprobs, bool get_confs) :
+file(nullptr), position(0), file_format(_file_format), allDim(_allDim)
+{
+    columns[0] = get_masses;
+    columns[1] = get_probs;
+    columns[2] = get_lprobs;
+    columns[3] = get_confs;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    throw std::runtime_error("Arrow output is only supported on little-endian hosts");
+#endif
+
+    file = fopen(path, "wb");
+    if(file == nullptr)
+        throw std::runtime_error("Could not open the output file");
+
+    if(file_format)
+    {
+        write(ARROW_MAGIC, 6);
+        pad(8);
+    }
+
+    FlatBuffer fb;
+    const size_t header = arrow_message(fb, ARROW_HEADER_SCHEMA, 0);
+    fb.link(header, arrow_schema(fb, columns, allDim));
+    write_metadata(fb.data);
+}
+
+ArrowIPCWriter::~ArrowIPCWriter()
+{
+    if(file != nullptr)
+        fclose(file);
+}
+
+void ArrowIPCWriter::write(const void* data, size_t size)
+{
+    if(fwrite(data, 1, size, file) != size)
+        throw std::runtime_error("Could not write to the output file");
+    position += size;
+}
+
+void ArrowIPCWriter::pad(size_t alignment)
+{
+    static const char zeros[ARROW_ALIGNMENT] = {0};
+    if(position % alignment != 0)
+        write(zeros, alignment - position % alignment);
+}
+
+int32_t ArrowIPCWriter::write_metadata(const std::vector<uint8_t>& metadata)
+{
+    // Continuation marker and length, then the flatbuffer padded so that the body
+    // starts aligned (the length has to cover the padding, as the file format
+    // starts off aligned only to 8 bytes)
+    const int32_t length = (position + 8 + metadata.size() + ARROW_ALIGNMENT - 1) / ARROW_ALIGNMENT * ARROW_ALIGNMENT - position - 8;
+    const uint32_t continuation = ARROW_CONTINUATION;
+    write(&continuation, 4);
+    write(&length, 4);
+    write(metadata.data(), metadata.size());
+    pad(ARROW_ALIGNMENT);
+    return 8 + length;
+}
+
+void ArrowIPCWriter::write_batch(size_t rows, const double* masses, const double* probs,
+                                 const double* lprobs, const int* confs)
+{
+    struct Buffer { int64_t offset; int64_t length; };
+    struct FieldNode { int64_t length; int64_t null_count; };
+
+    const double* doubles[3] = {masses, probs, lprobs};
+    const size_t aligned_doubles = (rows * sizeof(double) + ARROW_ALIGNMENT - 1) / ARROW_ALIGNMENT * ARROW_ALIGNMENT;
+    const size_t aligned_confs = (rows * allDim * sizeof(int) + ARROW_ALIGNMENT - 1) / ARROW_ALIGNMENT * ARROW_ALIGNMENT;
+
+    // Validity bitmaps are all empty, as there are no nulls
+    std::vector<Buffer> buffers;
+    std::vector<FieldNode> nodes;
+    int64_t body_length = 0;
+    for(int ii = 0; ii < 3; ii++)
+        if(columns[ii])
+        {
+            nodes.push_back(FieldNode{static_cast<int64_t>(rows), 0});
+            buffers.push_back(Buffer{body_length, 0});
+            buffers.push_back(Buffer{body_length, static_cast<int64_t>(rows * sizeof(double))});
+            body_length += aligned_doubles;
+        }
+    if(columns[3])
+    {
+        nodes.push_back(FieldNode{static_cast<int64_t>(rows), 0});
+        nodes.push_back(FieldNode{static_cast<int64_t>(rows * allDim), 0});
+        buffers.push_back(Buffer{body_length, 0});
+        buffers.push_back(Buffer{body_length, 0});
+        buffers.push_back(Buffer{body_length, static_cast<int64_t>(rows * allDim * sizeof(int))});
+        body_length += aligned_confs;
+    }
+
+    FlatBuffer fb;
+    const size_t header = arrow_message(fb, ARROW_HEADER_BATCH, body_length);
+    size_t pos[3];
+    fb.link(header, fb.table({{0, 8, rows}, {1, 4, 0}, {2, 4, 0}}, pos));
+    fb.link(pos[1], fb.vector(nodes.data(), nodes.size(), sizeof(FieldNode), 8));
+    fb.link(pos[2], fb.vector(buffers.data(), buffers.size(), sizeof(Buffer), 8));
+
+    Block block;
+    block.offset = position;
+    block.metadata_length = write_metadata(fb.data);
+    block.body_length = body_length;
+    blocks.push_back(block);
+
+    for(int ii = 0; ii < 3; ii++)
+        if(columns[ii])
+        {
+            write(doubles[ii], rows * sizeof(double));
+            pad(ARROW_ALIGNMENT);
+        }
+    if(columns[3])
+    {
+        write(confs, rows * allDim * sizeof(int));
+        pad(ARROW_ALIGNMENT);
+    }
+}
+
+void ArrowIPCWriter::close()
+{
+    const uint32_t eos[2] = {ARROW_CONTINUATION, 0};
+    write(eos, 8);
+
+    if(file_format)
+    {
+        struct FileBlock { int64_t offset; int32_t metadata_length; int32_t padding; int64_t body_length; };
+        std::vector<FileBlock> file_blocks;
+        for(const Block& b : blocks)
+            file_blocks.push_back(FileBlock{static_cast<int64_t>(b.offset), b.metadata_length, 0, static_cast<int64_t>(b.body_length)});
+
+        // version, schema, dictionaries, recordBatches
+        FlatBuffer fb;
+        size_t pos[4];
+        fb.set_root(fb.table({{0, 2, ARROW_METADATA_V5}, {1, 4, 0}, {2, 4, 0}, {3, 4, 0}}, pos));
+        fb.link(pos[1], arrow_schema(fb, columns, allDim));
+        fb.link(pos[2], fb.vector(nullptr, 0, sizeof(FileBlock), 8));
+        fb.link(pos[3], fb.vector(file_blocks.data(), file_blocks.size(), sizeof(FileBlock), 8));
+
+        const int32_t footer_length = fb.data.size();
+        write(fb.data.data(), fb.data.size());
+        write(&footer_length, 4);
+        write(ARROW_MAGIC, 6);
+    }
+
+    const int ret = fclose(file);
+    file = nullptr;
+    if(ret != 0)
+        throw std::runtime_error("Could not write to the output file");
+}
+
+
+template <typename T> ArrowTabulator<T>::ArrowTabulator(T* generator, const char* path, bool file_format,
+                     bool get_masses, bool get_probs,
+                     bool get_lprobs, bool get_confs,
+                     size_t batch_size ) :
+_confs_no(0)
+{
+    if(batch_size == 0)
+        throw std::invalid_argument("Arrow batches need at least one row");
+
+    const int allDim = generator->getAllDim();
+    ArrowIPCWriter writer(path, allDim, file_format, get_masses, get_probs, get_lprobs, get_confs);
+
+    std::vector<double> masses(get_masses ? batch_size : 0);
+    std::vector<double> probs(get_probs ? batch_size : 0);
+    std::vector<double> lprobs(get_lprobs ? batch_size : 0);
+    std::vector<int> confs(get_confs ? batch_size * allDim : 0);
+
+    size_t fill = 0;
+    while(generator->advanceToNextConfiguration())
+    {
+        if(get_masses) masses[fill] = generator->mass();
+        if(get_probs)  probs[fill]  = generator->eprob();
+        if(get_lprobs) lprobs[fill] = generator->lprob();
+        if(get_confs)  generator->get_conf_signature(confs.data() + fill * allDim);
+        fill++;
+        _confs_no++;
+
+        if(fill == batch_size)
+        {
+            writer.write_batch(fill, masses.data(), probs.data(), lprobs.data(), confs.data());
+            fill = 0;
+        }
+    }
+
+    if(fill > 0)
+        writer.write_batch(fill, masses.data(), probs.data(), lprobs.data(), confs.data());
+
+    writer.close();
+}
+
+template class ArrowTabulator<IsoThresholdGenerator>;
+template class ArrowTabulator<IsoLayeredGenerator>;
+template class ArrowTabulator<IsoOrderedGenerator>;
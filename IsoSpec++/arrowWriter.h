@@ -0,0 +1,92 @@
+/*
+ *   Copyright (C) 2015-2016 Mateusz Łącki and Michał Startek.
+ *
+ *   This file is part of IsoSpec.
+ *
+ *   IsoSpec is free software: you can redistribute it and/or modify
+ *   it under the terms of the Simplified ("2-clause") BSD licence.
+ *
+ *   IsoSpec is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *   You should have received a copy of the Simplified BSD Licence
+ *   along with IsoSpec.  If not, see <https://opensource.org/licenses/BSD-2-Clause>.
+ */
+
+
+#ifndef ARROWWRITER_H
+#define ARROWWRITER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include "isoSpec++.h"
+
+#define ARROW_DEFAULT_BATCH_SIZE (64*1024)
+
+/*
+ * Writer of the Apache Arrow IPC format, either as a stream or as a file (with the
+ * footer that allows random access to the batches), without depending on the Arrow
+ * libraries: the flatbuffer metadata is put together by hand. Columns, as requested:
+ * mass, prob, lprob (float64) and conf, a fixed_size_list<int32> of allDim isotope
+ * counts, in the order of get_conf_signature. Nothing is nullable.
+ */
+class ArrowIPCWriter
+{
+private:
+    struct Block
+    {
+        uint64_t offset;
+        int32_t  metadata_length;
+        uint64_t body_length;
+    };
+
+    FILE* file;
+    uint64_t position;
+    const bool file_format;
+    const int allDim;
+    bool columns[4];            // mass, prob, lprob, conf
+    std::vector<Block> blocks;
+
+    void write(const void* data, size_t size);
+    void pad(size_t alignment);
+    int32_t write_metadata(const std::vector<uint8_t>& metadata);
+
+public:
+    // Throws std::runtime_error if the file can't be written, or if the host is
+    // big-endian: everything is written in host byte order, and the format (the
+    // flatbuffer metadata included) is little-endian
+    ArrowIPCWriter(const char* path, int allDim, bool file_format,
+                   bool get_masses, bool get_probs,
+                   bool get_lprobs, bool get_confs);
+    ~ArrowIPCWriter();
+
+    // Null pointers for the columns that were not requested
+    void write_batch(size_t rows, const double* masses, const double* probs,
+                     const double* lprobs, const int* confs);
+
+    // Writes the end of stream marker (and the footer); no more batches after that
+    void close();
+};
+
+
+/*
+ * Everything the generator produces, written into an Arrow stream or file in
+ * record batches of batch_size rows. Throws std::invalid_argument if batch_size is 0.
+ */
+template <typename T> class ArrowTabulator
+{
+private:
+    size_t _confs_no;
+
+public:
+    ArrowTabulator(T* generator, const char* path, bool file_format,
+                   bool get_masses, bool get_probs,
+                   bool get_lprobs, bool get_confs,
+                   size_t batch_size = ARROW_DEFAULT_BATCH_SIZE);
+
+    inline size_t confs_no() const { return _confs_no; };
+};
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ *   Copyright (C) 2015-2016 Mateusz Łącki and Michał Startek.
+ *
+ *   This file is part of IsoSpec.
+ *
+ *   IsoSpec is free software: you can redistribute it and/or modify
+ *   it under the terms of the Simplified ("2-clause") BSD licence.
+ *
+ *   IsoSpec is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *   You should have received a copy of the Simplified BSD Licence
+ *   along with IsoSpec.  If not, see <https://opensource.org/licenses/BSD-2-Clause>.
+ */
+
+
+#include "confSet.h"
+
+
+static inline size_t max_load(size_t capacity)
+{
+    return capacity - capacity/8;
+}
+
+ConfSet::ConfSet(int _dim, size_t slots, MemoryResource* _resource) :
+dim(_dim),
+capacity(CONFSET_GROUP),
+count(0),
+growth_left(0),
+ctrl(nullptr),
+confs(nullptr),
+resource(_resource)
+{
+    while(capacity < slots)
+        capacity *= 2;
+
+    ctrl = resource_new<uint8_t>(resource, capacity);
+    try
+    {
+        confs = resource_new<int>(resource, capacity*dim);
+    }
+    catch(...)
+    {
+        resource_delete(resource, ctrl, capacity);
+        throw;
+    }
+    memset(ctrl, EMPTY, capacity);
+    growth_left = max_load(capacity);
+}
+
+ConfSet::~ConfSet()
+{
+    resource_delete(resource, ctrl, capacity);
+    resource_delete(resource, confs, capacity*dim);
+}
+
+// Groups are visited in triangular steps from the one the hash points to, which
+// goes through all of them as their number is a power of two. The search always
+// ends, as some slot is always empty.
+
+size_t ConfSet::find(const int* conf, uint64_t h) const
+{
+    const size_t group_mask = capacity/CONFSET_GROUP - 1;
+    const uint8_t tag = h & 0x7F;
+    size_t g = (h >> 7) & group_mask;
+    for(size_t step = 1; ; step++)
+    {
+        const uint64_t ctrls = group(g*CONFSET_GROUP);
+        for(uint64_t matches = match_tag(ctrls, tag); matches != 0; matches &= matches - 1)
+        {
+            const size_t slot = g*CONFSET_GROUP + lowest_byte(matches);
+            if(equal(conf, slot))
+                return slot;
+        }
+        if(match_empty(ctrls) != 0)
+            return capacity;
+        g = (g + step) & group_mask;
+    }
+}
+
+size_t ConfSet::find_free(uint64_t h) const
+{
+    const size_t group_mask = capacity/CONFSET_GROUP - 1;
+    size_t g = (h >> 7) & group_mask;
+    for(size_t step = 1; ; step++)
+    {
+        const uint64_t free_slots = match_free(group(g*CONFSET_GROUP));
+        if(free_slots != 0)
+            return g*CONFSET_GROUP + lowest_byte(free_slots);
+        g = (g + step) & group_mask;
+    }
+}
+
+bool ConfSet::insert(const int* conf)
+{
+    const uint64_t h = hash(conf);
+    if(find(conf, h) < capacity)
+        return false;
+
+    size_t slot = find_free(h);
+    if(ctrl[slot] == EMPTY and growth_left == 0)
+    {
+        // Full of configurations, or of deleted ones: in the latter case clearing
+        // them out is enough
+        rehash(count >= max_load(capacity)/2 ? capacity*2 : capacity);
+        slot = find_free(h);
+    }
+
+    if(ctrl[slot] == EMPTY)
+        growth_left--;
+    ctrl[slot] = h & 0x7F;
+    memcpy(conf_at(slot), conf, dim*sizeof(int));
+    count++;
+    return true;
+}
+
+bool ConfSet::erase(const int* conf)
+{
+    const size_t slot = find(conf, hash(conf));
+    if(slot >= capacity)
+        return false;
+
+    // A group that has an empty slot has had it since the table was last built,
+    // so no search ever went past it: the slot may be emptied too
+    if(match_empty(group(slot - slot % CONFSET_GROUP)) != 0)
+    {
+        ctrl[slot] = EMPTY;
+        growth_left++;
+    }
+    else
+        ctrl[slot] = DELETED;
+    count--;
+    return true;
+}
+
+void ConfSet::rehash(size_t new_capacity)
+{
+    uint8_t* const old_ctrl = ctrl;
+    int* const old_confs = confs;
+    const size_t old_capacity = capacity;
+
+    uint8_t* new_ctrl = resource_new<uint8_t>(resource, new_capacity);
+    try
+    {
+        confs = resource_new<int>(resource, new_capacity*dim);
+    }
+    catch(...)
+    {
+        resource_delete(resource, new_ctrl, new_capacity);
+        throw;
+    }
+    ctrl = new_ctrl;
+    capacity = new_capacity;
+    memset(ctrl, EMPTY, capacity);
+
+    for(size_t ii = 0; ii < old_capacity; ii++)
+        if(old_ctrl[ii] < EMPTY)
+        {
+            const int* conf = old_confs + ii*dim;
+            const size_t slot = find_free(hash(conf));
+            ctrl[slot] = old_ctrl[ii];
+            memcpy(conf_at(slot), conf, dim*sizeof(int));
+        }
+    growth_left = max_load(capacity) - count;
+
+    resource_delete(resource, old_ctrl, old_capacity);
+    resource_delete(resource, old_confs, old_capacity*dim);
+}
@@ -0,0 +1,131 @@
+/*
+ *   Copyright (C) 2015-2016 Mateusz Łącki and Michał Startek.
+ *
+ *   This file is part of IsoSpec.
+ *
+ *   IsoSpec is free software: you can redistribute it and/or modify
+ *   it under the terms of the Simplified ("2-clause") BSD licence.
+ *
+ *   IsoSpec is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *   You should have received a copy of the Simplified BSD Licence
+ *   along with IsoSpec.  If not, see <https://opensource.org/licenses/BSD-2-Clause>.
+ */
+
+
+#ifndef CONFSET_HPP
+#define CONFSET_HPP
+
+#include <stdint.h>
+#include <string.h>
+#include "conf.h"
+#include "arena.h"
+
+
+#define CONFSET_GROUP 8
+
+/*
+ * Set of configurations of a marginal (dim ints each), kept by value in one flat
+ * open-addressing table: looking one up touches the table only, not the pages of
+ * an Allocator, and there are no nodes to allocate. Each slot has a control byte,
+ * either empty, deleted, or 7 bits of the hash of its configuration. Slots are
+ * probed in aligned groups of CONFSET_GROUP, whose control bytes are matched
+ * against the hash all at once as one 64-bit word, and a group with an empty slot
+ * ends the search. At most 7/8 of the slots are taken, deleted ones included.
+ * If the resource throws while the table grows, the set stays as it was.
+ */
+class ConfSet
+{
+private:
+    const int dim;
+    size_t capacity;        // slots, a power of two, at least one group
+    size_t count;
+    size_t growth_left;     // empty slots that may still be taken before growing
+    uint8_t* ctrl;
+    int* confs;             // dim ints for every slot
+    MemoryResource* const resource;
+
+    static const uint8_t EMPTY = 0x80;
+    static const uint8_t DELETED = 0xFE;
+
+    inline uint64_t hash(const int* conf) const
+    {
+        uint64_t h = 0;
+        for(int ii = 0; ii < dim; ii++)
+            h = (h ^ static_cast<uint32_t>(conf[ii])) * 0x9E3779B97F4A7C15ULL;
+        // Finalizer of MurmurHash3, so that all the bits depend on all the counts
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    inline uint64_t group(size_t first_slot) const
+    {
+        // Assembled byte by byte to be independent of endianness: compilers make
+        // a single load of it
+        uint64_t ret = 0;
+        for(int ii = 0; ii < CONFSET_GROUP; ii++)
+            ret |= static_cast<uint64_t>(ctrl[first_slot + ii]) << (8*ii);
+        return ret;
+    }
+
+    // High bit of byte ii set for the slots of the group that match
+    static inline uint64_t match_tag(uint64_t group, uint8_t tag)
+    {
+        const uint64_t x = group ^ (0x0101010101010101ULL * tag);
+        // May have false positives after a true one, which comparing confs sorts out
+        return (x - 0x0101010101010101ULL) & ~x & 0x8080808080808080ULL;
+    }
+
+    static inline uint64_t match_empty(uint64_t group) { return group & ~(group << 6) & 0x8080808080808080ULL; }
+    static inline uint64_t match_free(uint64_t group) { return group & ~(group << 7) & 0x8080808080808080ULL; }
+
+    static inline int lowest_byte(uint64_t mask)
+    {
+#if defined(__GNUC__)
+        return __builtin_ctzll(mask) >> 3;
+#else
+        int ret = 0;
+        while((mask & 0xFF) == 0)
+        {
+            mask >>= 8;
+            ret++;
+        }
+        return ret;
+#endif
+    }
+
+    inline int* conf_at(size_t slot) const { return confs + slot*dim; }
+    inline bool equal(const int* conf, size_t slot) const { return memcmp(conf, conf_at(slot), dim*sizeof(int)) == 0; }
+
+    // Slot holding conf, or capacity if there is none
+    size_t find(const int* conf, uint64_t h) const;
+    // First free (empty or deleted) slot on the probe sequence of h
+    size_t find_free(uint64_t h) const;
+    void rehash(size_t new_capacity);
+
+public:
+    // Starts with slots slots, rounded up to a power of two: 7/8 of them can be
+    // taken before it grows
+    ConfSet(int dim, size_t slots = 16, MemoryResource* resource = default_memory_resource());
+    ConfSet(const ConfSet& other) = delete;
+    ConfSet& operator=(const ConfSet& other) = delete;
+    ~ConfSet();
+
+    inline bool contains(const int* conf) const { return find(conf, hash(conf)) < capacity; };
+
+    // Copies conf in, unless it's there already: returns whether it wasn't
+    bool insert(const int* conf);
+
+    // Returns whether conf was there
+    bool erase(const int* conf);
+
+    inline size_t size() const { return count; };
+};
+
+#endif
@@ -16,6 +16,9 @@
 
 
 #include <tuple>
+#include <cmath>
+#include <limits>
+#include <vector>
 #include <string.h>
 #include <iostream>
 #include <algorithm>
@@ -24,9 +27,67 @@
 #include "misc.h"
 #include "marginalTrek++.h"
 #include "isoSpec++.h"
+#include "isotopeLabels.h"
 #include "tabulator.h"
+#include "arrowWriter.h"
+#include "spectrum2.h"
 
 
+// What the generators of a multithreaded threshold enumeration share
+struct ThresholdMTMarginals
+{
+    Iso iso;
+    const double threshold;
+    const bool absolute;
+    PrecalculatedMarginal** const PMs;
+
+    ThresholdMTMarginals(Iso&& _iso, double _threshold, bool _absolute, int tabSize, int hashSize) :
+    iso(std::move(_iso)),
+    threshold(_threshold),
+    absolute(_absolute),
+    PMs(iso.get_MT_marginal_set(threshold > 0.0 ? log(threshold) : std::numeric_limits<double>::lowest(),
+                                absolute, tabSize, hashSize))
+    {}
+
+    ~ThresholdMTMarginals() { iso.free_MT_marginal_set(PMs); }
+};
+
+template <typename T> static int fill_chunk(T* generator, int max_rows,
+                                            double* masses, double* probs, double* lprobs, int* confs)
+{
+    const int allDim = generator->getAllDim();
+    int rows = 0;
+    while(rows < max_rows and generator->advanceToNextConfiguration())
+    {
+        if(masses != nullptr) masses[rows] = generator->mass();
+        if(probs  != nullptr) probs[rows]  = generator->eprob();
+        if(lprobs != nullptr) lprobs[rows] = generator->lprob();
+        if(confs  != nullptr) generator->get_conf_signature(confs + static_cast<size_t>(rows)*allDim);
+        rows++;
+    }
+    return rows;
+}
+
+template <typename T> static long long stream_chunks(T* generator, int max_rows,
+                                                     double* masses, double* probs, double* lprobs, int* confs,
+                                                     chunk_callback callback, void* user_data)
+{
+    if(max_rows <= 0)
+        return 0;
+
+    long long total = 0;
+    int rows;
+    do
+    {
+        rows = fill_chunk(generator, max_rows, masses, probs, lprobs, confs);
+        total += rows;
+        if(rows > 0 and not callback(user_data, rows))
+            break;
+    }
+    while(rows == max_rows);
+    return total;
+}
+
 extern "C"
 {
 void * setupIso(int             dimNumber,
@@ -54,11 +115,102 @@ void * setupIso(int             dimNumber,
     return reinterpret_cast<void*>(iso);
 }
 
+void * setupIsoFromElements(int         dimNumber,
+                            const int*  atomicNumbers,
+                            const int*  atomCounts)
+{
+    try
+    {
+        return reinterpret_cast<void*>(new Iso(dimNumber, atomicNumbers, atomCounts));
+    }
+    catch(std::invalid_argument&)
+    {
+        return nullptr;
+    }
+}
+
 void deleteIso(void* iso)
 {
     delete reinterpret_cast<Iso*>(iso);
 }
 
+void setHugePages(bool enabled)
+{
+    set_huge_pages(enabled);
+}
+
+int registerIsotopeLabel(const char* name, const char* element, const char* spec)
+{
+    try
+    {
+        register_isotope_label(name, element, spec);
+        return 0;
+    }
+    catch(std::invalid_argument&)
+    {
+        return -1;
+    }
+}
+
+int isotopeLabelProbabilities(const char* element, const char* label, double* space, int space_size)
+{
+    int isotope_no;
+    const int first = find_element(element, strlen(element), &isotope_no);
+    if(first < 0 or isotope_no > space_size)
+        return -1;
+    try
+    {
+        memcpy(space, labelled_probabilities(first, label, strlen(label)), isotope_no*sizeof(double));
+        return isotope_no;
+    }
+    catch(std::invalid_argument&)
+    {
+        return -1;
+    }
+}
+
+int parseFormula(const char* formula, int* isotopeNumbers, int* atomCounts,
+                 double* isotopeMasses, double* isotopeProbabilities,
+                 int max_elements, int max_isotopes)
+{
+    std::vector<const double*> IM;
+    std::vector<const double*> IP;
+    int* isoNumbers;
+    int* counts;
+    unsigned int confSize;
+    int dimNumber;
+    try
+    {
+        dimNumber = parse_formula(formula, IM, IP, &isoNumbers, &counts, &confSize);
+    }
+    catch(std::exception&)
+    {
+        return -1;
+    }
+
+    int idx = 0;
+    for(int i=0; i<dimNumber; i++)
+        idx += isoNumbers[i];
+
+    const bool fits = dimNumber <= max_elements and idx <= max_isotopes;
+    if(fits)
+    {
+        idx = 0;
+        for(int i=0; i<dimNumber; i++)
+        {
+            isotopeNumbers[i] = isoNumbers[i];
+            atomCounts[i] = counts[i];
+            memcpy(isotopeMasses + idx, IM[i], isoNumbers[i]*sizeof(double));
+            memcpy(isotopeProbabilities + idx, IP[i], isoNumbers[i]*sizeof(double));
+            idx += isoNumbers[i];
+        }
+    }
+
+    resource_delete(default_memory_resource(), isoNumbers, dimNumber);
+    resource_delete(default_memory_resource(), counts, dimNumber);
+    return fits ? dimNumber : -1;
+}
+
 
 #define C_CODE(generatorType, dataType, method)\
 dataType method##generatorType(void* generator){ return reinterpret_cast<generatorType*>(generator)->method(); }
@@ -70,12 +222,32 @@ void get_conf_signature##generatorType(void* generator, int* space)\
 
 #define DELETE(generatorType) void delete##generatorType(void* generator){ delete reinterpret_cast<generatorType*>(generator); }
 
+#define C_CODE_CHUNKS(generatorType)\
+int nextChunk##generatorType(void* generator, int max_rows,\
+                             double* masses, double* probs, double* lprobs, int* confs)\
+{ return fill_chunk(reinterpret_cast<generatorType*>(generator), max_rows, masses, probs, lprobs, confs); }\
+long long streamChunks##generatorType(void* generator, int max_rows,\
+                                      double* masses, double* probs, double* lprobs, int* confs,\
+                                      chunk_callback callback, void* user_data)\
+{ return stream_chunks(reinterpret_cast<generatorType*>(generator), max_rows, masses, probs, lprobs, confs, callback, user_data); }
+
+// Out of range components take no memory
+#define C_CODE_MEMORY(generatorType)\
+size_t memoryUsed##generatorType(void* generator, int component)\
+{ return component < 0 or component > MEMORY_TOTAL ? 0 :\
+         reinterpret_cast<generatorType*>(generator)->memory_used(static_cast<MemoryComponent>(component)); }\
+size_t memoryPeak##generatorType(void* generator, int component)\
+{ return component < 0 or component > MEMORY_TOTAL ? 0 :\
+         reinterpret_cast<generatorType*>(generator)->memory_peak(static_cast<MemoryComponent>(component)); }
+
 #define C_CODES(generatorType)\
 C_CODE(generatorType, double, mass) \
 C_CODE(generatorType, double, lprob) \
 C_CODE_GET_CONF_SIGNATURE(generatorType) \
 C_CODE(generatorType, bool, advanceToNextConfiguration) \
-DELETE(generatorType)
+DELETE(generatorType) \
+C_CODE_CHUNKS(generatorType) \
+C_CODE_MEMORY(generatorType)
 
 
 
@@ -129,53 +301,324 @@ void* setupIsoOrderedGenerator(void* iso,
 }
 C_CODES(IsoOrderedGenerator)
 
+
+//______________________________________________________MULTITHREADED THRESHOLD GENERATOR
+void* setupThresholdMTMarginals(void* iso,
+                                double threshold,
+                                bool _absolute,
+                                int _tabSize,
+                                int _hashSize)
+{
+    ThresholdMTMarginals* marginals = new ThresholdMTMarginals(
+        std::move(*reinterpret_cast<Iso*>(iso)),
+        threshold,
+        _absolute,
+        _tabSize,
+        _hashSize);
+
+    return reinterpret_cast<void*>(marginals);
+}
+
+void deleteThresholdMTMarginals(void* marginals){ delete reinterpret_cast<ThresholdMTMarginals*>(marginals); }
+
+void* setupIsoThresholdGeneratorMT(void* marginals)
+{
+    ThresholdMTMarginals* shared = reinterpret_cast<ThresholdMTMarginals*>(marginals);
+    IsoThresholdGeneratorMT* iso_tmp = new IsoThresholdGeneratorMT(
+        std::move(shared->iso),
+        shared->threshold,
+        shared->PMs,
+        shared->absolute);
+
+    return reinterpret_cast<void*>(iso_tmp);
+}
+C_CODES(IsoThresholdGeneratorMT)
+
+#define C_TABULATOR_CODES(tabulatorName, tabulatorType)\
+void delete##tabulatorName(void* tabulator){ delete reinterpret_cast<tabulatorType*>(tabulator); }\
+const double* masses##tabulatorName(void* tabulator){ return reinterpret_cast<tabulatorType*>(tabulator)->masses(); }\
+const double* lprobs##tabulatorName(void* tabulator){ return reinterpret_cast<tabulatorType*>(tabulator)->lprobs(); }\
+const double* probs##tabulatorName(void* tabulator){ return reinterpret_cast<tabulatorType*>(tabulator)->probs(); }\
+const int* confs##tabulatorName(void* tabulator){ return reinterpret_cast<tabulatorType*>(tabulator)->confs(); }\
+size_t confs_no##tabulatorName(void* tabulator){ return reinterpret_cast<tabulatorType*>(tabulator)->confs_no(); }\
+int confs_dim##tabulatorName(void* tabulator){ return reinterpret_cast<tabulatorType*>(tabulator)->confs_dim(); }\
+void get_conf_signature##tabulatorName(void* tabulator, size_t idx, int* space)\
+{ reinterpret_cast<tabulatorType*>(tabulator)->get_conf_signature(idx, space); }
+
+
 //______________________________________________________ Threshold Tabulator 1.0
 
 void* setupThresholdTabulator(void* generator,
                      bool  get_masses,
                      bool  get_probs,
                      bool  get_lprobs,
-                     bool  get_confs)
+                     bool  get_confs,
+                     bool  compress_confs)
 {
-    Tabulator<IsoThresholdGenerator>* tabulator = new Tabulator<IsoThresholdGenerator>(reinterpret_cast<IsoThresholdGenerator*>(generator),
+    try
+    {
+        return reinterpret_cast<void*>(new Tabulator<IsoThresholdGenerator>(reinterpret_cast<IsoThresholdGenerator*>(generator),
                                          get_masses,
                                          get_probs,
                                          get_lprobs,
-                                         get_confs);
+                                         get_confs,
+                                         compress_confs));
+    }
+    catch(...)
+    {
+        return nullptr;
+    }
+}
+C_TABULATOR_CODES(ThresholdTabulator, Tabulator<IsoThresholdGenerator>)
 
-    return reinterpret_cast<void*>(tabulator);
+//______________________________________________________ Layered Tabulator (optimal p-set)
+
+void* setupLayeredTabulator(void* generator,
+                     double target_total_prob,
+                     bool  optimize,
+                     bool  get_masses,
+                     bool  get_probs,
+                     bool  get_lprobs,
+                     bool  get_confs,
+                     bool  compress_confs)
+{
+    try
+    {
+        return reinterpret_cast<void*>(new LayeredTabulator(reinterpret_cast<IsoLayeredGenerator*>(generator),
+                                         target_total_prob,
+                                         optimize,
+                                         get_masses,
+                                         get_probs,
+                                         get_lprobs,
+                                         get_confs,
+                                         compress_confs));
+    }
+    catch(...)
+    {
+        return nullptr;
+    }
 }
+C_TABULATOR_CODES(LayeredTabulator, LayeredTabulator)
 
-void deleteThresholdTabulator(void* t)
+double total_probLayeredTabulator(void* tabulator)
 {
-    delete reinterpret_cast<Tabulator<IsoThresholdGenerator>*>(t);
+    return reinterpret_cast<LayeredTabulator*>(tabulator)->total_prob();
 }
 
-const double* massesThresholdTabulator(void* tabulator)
+//______________________________________________________ Ordered Tabulator
+
+void* setupOrderedTabulator(void* generator,
+                     double target_total_prob,
+                     bool  get_masses,
+                     bool  get_probs,
+                     bool  get_lprobs,
+                     bool  get_confs,
+                     bool  compress_confs)
 {
-    return reinterpret_cast<Tabulator<IsoThresholdGenerator>*>(tabulator)->masses();
+    try
+    {
+        return reinterpret_cast<void*>(new OrderedTabulator(reinterpret_cast<IsoOrderedGenerator*>(generator),
+                                         target_total_prob,
+                                         get_masses,
+                                         get_probs,
+                                         get_lprobs,
+                                         get_confs,
+                                         compress_confs));
+    }
+    catch(...)
+    {
+        return nullptr;
+    }
 }
+C_TABULATOR_CODES(OrderedTabulator, OrderedTabulator)
 
-const double* lprobsThresholdTabulator(void* tabulator)
+double total_probOrderedTabulator(void* tabulator)
 {
-    return reinterpret_cast<Tabulator<IsoThresholdGenerator>*>(tabulator)->lprobs();
+    return reinterpret_cast<OrderedTabulator*>(tabulator)->total_prob();
 }
 
-const double* probsThresholdTabulator(void* tabulator)
+//______________________________________________________ Multithreaded Threshold Tabulator
+
+void* setupThresholdTabulatorMT(void* iso,
+                     double threshold,
+                     bool  _absolute,
+                     int   n_threads,
+                     bool  get_masses,
+                     bool  get_probs,
+                     bool  get_lprobs,
+                     bool  get_confs,
+                     bool  compress_confs,
+                     int   _tabSize,
+                     int   _hashSize)
+{
+    try
+    {
+        return reinterpret_cast<void*>(new ThresholdTabulatorMT(std::move(*reinterpret_cast<Iso*>(iso)),
+                                         threshold,
+                                         _absolute,
+                                         n_threads > 0 ? n_threads : 0,
+                                         get_masses,
+                                         get_probs,
+                                         get_lprobs,
+                                         get_confs,
+                                         _tabSize,
+                                         _hashSize,
+                                         compress_confs));
+    }
+    catch(...)
+    {
+        return nullptr;
+    }
+}
+C_TABULATOR_CODES(ThresholdTabulatorMT, ThresholdTabulatorMT)
+
+//______________________________________________________ Batch Threshold Tabulator
+
+void* setupBatchThresholdTabulator(const char* const* formulas,
+                                   size_t molecules_no,
+                                   double threshold,
+                                   bool  _absolute,
+                                   int   n_threads,
+                                   bool  get_masses,
+                                   bool  get_probs,
+                                   bool  get_lprobs,
+                                   bool  get_confs)
 {
-    return reinterpret_cast<Tabulator<IsoThresholdGenerator>*>(tabulator)->probs();
+    try
+    {
+        return reinterpret_cast<void*>(new BatchThresholdTabulator(formulas, molecules_no, threshold, _absolute, n_threads,
+                                                                   get_masses, get_probs, get_lprobs, get_confs));
+    }
+    catch(std::exception&)
+    {
+        return nullptr;
+    }
 }
 
-const int*    confsThresholdTabulator(void* tabulator)
+void* setupBatchThresholdTabulatorFromCounts(size_t molecules_no,
+                                             int dimNumber,
+                                             const int* isotopeNumbers,
+                                             const int* atomCounts,
+                                             const double* isotopeMasses,
+                                             const double* isotopeProbabilities,
+                                             double threshold,
+                                             bool  _absolute,
+                                             int   n_threads,
+                                             bool  get_masses,
+                                             bool  get_probs,
+                                             bool  get_lprobs,
+                                             bool  get_confs)
 {
-    return reinterpret_cast<Tabulator<IsoThresholdGenerator>*>(tabulator)->confs();
+    try
+    {
+        std::vector<const double*> IM(dimNumber);
+        std::vector<const double*> IP(dimNumber);
+        int idx = 0;
+        for(int i=0; i<dimNumber; i++)
+        {
+            IM[i] = &isotopeMasses[idx];
+            IP[i] = &isotopeProbabilities[idx];
+            idx += isotopeNumbers[i];
+        }
+
+        return reinterpret_cast<void*>(new BatchThresholdTabulator(molecules_no, dimNumber, isotopeNumbers, atomCounts,
+                                                                   IM.data(), IP.data(), threshold, _absolute, n_threads,
+                                                                   get_masses, get_probs, get_lprobs, get_confs));
+    }
+    catch(std::exception&)
+    {
+        return nullptr;
+    }
 }
 
-int confs_noThresholdTabulator(void* tabulator)
+void deleteBatchThresholdTabulator(void* tabulator){ delete reinterpret_cast<BatchThresholdTabulator*>(tabulator); }
+const double* massesBatchThresholdTabulator(void* tabulator){ return reinterpret_cast<BatchThresholdTabulator*>(tabulator)->masses(); }
+const double* lprobsBatchThresholdTabulator(void* tabulator){ return reinterpret_cast<BatchThresholdTabulator*>(tabulator)->lprobs(); }
+const double* probsBatchThresholdTabulator(void* tabulator){ return reinterpret_cast<BatchThresholdTabulator*>(tabulator)->probs(); }
+const int* confsBatchThresholdTabulator(void* tabulator){ return reinterpret_cast<BatchThresholdTabulator*>(tabulator)->confs(); }
+const size_t* offsetsBatchThresholdTabulator(void* tabulator){ return reinterpret_cast<BatchThresholdTabulator*>(tabulator)->offsets(); }
+const size_t* conf_offsetsBatchThresholdTabulator(void* tabulator){ return reinterpret_cast<BatchThresholdTabulator*>(tabulator)->conf_offsets(); }
+size_t confs_noBatchThresholdTabulator(void* tabulator){ return reinterpret_cast<BatchThresholdTabulator*>(tabulator)->confs_no(); }
+
+//______________________________________________________ Multithreaded binned spectrum
+
+void* setupSpectrum(void* iso,
+                    double bucket_width,
+                    double threshold,
+                    bool  _absolute,
+                    int   n_threads)
 {
-    return reinterpret_cast<Tabulator<IsoThresholdGenerator>*>(tabulator)->confs_no();
+    Spectrum* spectrum = nullptr;
+    try
+    {
+        spectrum = new Spectrum(std::move(*reinterpret_cast<Iso*>(iso)),
+                                bucket_width,
+                                threshold,
+                                _absolute);
+        spectrum->run(n_threads);
+    }
+    catch(...)
+    {
+        delete spectrum;
+        return nullptr;
+    }
+
+    return reinterpret_cast<void*>(spectrum);
+}
+
+void deleteSpectrum(void* spectrum){ delete reinterpret_cast<Spectrum*>(spectrum); }
+const double* bucketsSpectrum(void* spectrum){ return reinterpret_cast<Spectrum*>(spectrum)->get_buckets(); }
+long long n_bucketsSpectrum(void* spectrum){ return reinterpret_cast<Spectrum*>(spectrum)->get_n_buckets(); }
+double first_bucket_massSpectrum(void* spectrum){ return reinterpret_cast<Spectrum*>(spectrum)->first_bucket_mass(); }
+long long total_confsSpectrum(void* spectrum){ return reinterpret_cast<Spectrum*>(spectrum)->get_total_confs(); }
+double total_probSpectrum(void* spectrum){ return reinterpret_cast<Spectrum*>(spectrum)->get_total_prob(); }
+
+
+
+//______________________________________________________ File output
+
+#define C_CODE_TABULATE_TO_FILE(generatorType)\
+long long tabulateToFile##generatorType(void* generator, const char* path,\
+                                        bool get_masses, bool get_probs,\
+                                        bool get_lprobs, bool get_confs)\
+{\
+    try\
+    {\
+        FileTabulator<generatorType> tabulator(reinterpret_cast<generatorType*>(generator), path,\
+                                               get_masses, get_probs, get_lprobs, get_confs);\
+        return tabulator.confs_no();\
+    }\
+    catch(...)\
+    {\
+        return -1;\
+    }\
+}
+
+C_CODE_TABULATE_TO_FILE(IsoThresholdGenerator)
+C_CODE_TABULATE_TO_FILE(IsoLayeredGenerator)
+C_CODE_TABULATE_TO_FILE(IsoOrderedGenerator)
+
+#define C_CODE_WRITE_ARROW(generatorType)\
+long long writeArrow##generatorType(void* generator, const char* path, bool file_format,\
+                                    bool get_masses, bool get_probs,\
+                                    bool get_lprobs, bool get_confs)\
+{\
+    try\
+    {\
+        ArrowTabulator<generatorType> tabulator(reinterpret_cast<generatorType*>(generator), path, file_format,\
+                                                get_masses, get_probs, get_lprobs, get_confs);\
+        return tabulator.confs_no();\
+    }\
+    catch(...)\
+    {\
+        return -1;\
+    }\
 }
 
+C_CODE_WRITE_ARROW(IsoThresholdGenerator)
+C_CODE_WRITE_ARROW(IsoLayeredGenerator)
+C_CODE_WRITE_ARROW(IsoOrderedGenerator)
+
 
 
 }  //extern "C" ends here
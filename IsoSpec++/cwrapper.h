@@ -19,6 +19,8 @@
 #ifndef CWRAPPER_H
 #define CWRAPPER_H
 
+#include <stddef.h>
+
 #define ALGO_LAYERED 0
 #define ALGO_ORDERED 1
 #define ALGO_THRESHOLD_ABSOLUTE 2
@@ -32,26 +34,80 @@ extern "C" {
 #include <stdbool.h>
 #endif
 
+// Rows with identical isotope tables are merged into one marginal. Configuration
+// signatures keep one entry per isotope of each row: the merged atoms are split
+// back among the rows, each taking its own atom count, in the order of the isotopes.
 void * setupIso(int             dimNumber,
                 const int*      isotopeNumbers,
                 const int*      atomCounts,
                 const double*   isotopeMasses,
                 const double*   isotopeProbabilities);
 
+// Elements given by atomic number, with natural abundances; NULL for unknown ones
+void * setupIsoFromElements(int         dimNumber,
+                            const int*  atomicNumbers,
+                            const int*  atomCounts);
+
 void deleteIso(void* iso);
 
+// Isotope labels (see isotopeLabels.h). registerIsotopeLabel returns 0, or -1 on
+// invalid input. isotopeLabelProbabilities writes the abundances of the element's
+// isotopes under the label (a registered name or a spec such as "13C=0.99") into
+// space, and returns their number, or -1 if the element or label is invalid or
+// there is not enough space.
+int registerIsotopeLabel(const char* name, const char* element, const char* spec);
+int isotopeLabelProbabilities(const char* element, const char* label, double* space, int space_size);
+
+// Parses a formula as Iso does, into the arguments of setupIso: the number of
+// isotopes and the atom count of each element, and the masses and probabilities
+// of their isotopes, one element after another. Returns the number of elements,
+// or -1 if the formula is invalid or there is not enough space (max_elements
+// elements, max_isotopes isotopes in all).
+int parseFormula(const char* formula, int* isotopeNumbers, int* atomCounts,
+                 double* isotopeMasses, double* isotopeProbabilities,
+                 int max_elements, int max_isotopes);
+
+// Back large tables (binned spectra, the log-factorial table, and the tables of
+// Isos created from now on) with transparent huge pages; off by default
+void setHugePages(bool enabled);
+
 #define C_HEADER(generatorType, dataType, method)\
 dataType method##generatorType(void* generator);
 
 #define C_HEADER_GET_CONF_SIGNATURE(generatorType)\
-void method##generatorType(void* generator);
+void get_conf_signature##generatorType(void* generator, int* space);
+
+// Streaming in chunks: the caller provides buffers for max_rows configurations
+// (allDim ints per row for confs), or nulls for the columns it doesn't need.
+// nextChunk fills them with the next configurations and returns how many it
+// wrote; less than max_rows means the generator is exhausted. streamChunks does
+// the same until the end, calling callback after each chunk is filled (stopping
+// early if it returns false), and returns the total number of configurations.
+typedef bool (*chunk_callback)(void* user_data, int rows);
+
+#define C_HEADER_CHUNKS(generatorType)\
+int nextChunk##generatorType(void* generator, int max_rows,\
+                             double* masses, double* probs, double* lprobs, int* confs);\
+long long streamChunks##generatorType(void* generator, int max_rows,\
+                                      double* masses, double* probs, double* lprobs, int* confs,\
+                                      chunk_callback callback, void* user_data);
+
+// Bytes taken by the generator (and the Iso it was made from), currently and at
+// most so far, by component: 0 the Iso's tables, 1 the configurations of the
+// marginals, 2 configuration pages, 3 hash tables, 4 priority queues, 5 the
+// generator's own state, 6 all of them together (see MemoryComponent)
+#define C_HEADER_MEMORY(generatorType)\
+size_t memoryUsed##generatorType(void* generator, int component);\
+size_t memoryPeak##generatorType(void* generator, int component);
 
 #define C_HEADERS(generatorType)\
 C_HEADER(generatorType, double, mass) \
 C_HEADER(generatorType, double, lprob) \
 C_HEADER_GET_CONF_SIGNATURE(generatorType) \
 C_HEADER(generatorType, bool, advanceToNextConfiguration) \
-C_HEADER(generatorType, void, delete)
+C_HEADER(generatorType, void, delete) \
+C_HEADER_CHUNKS(generatorType) \
+C_HEADER_MEMORY(generatorType)
 
 
 
@@ -79,21 +135,158 @@ void* setupIsoOrderedGenerator(void* iso,
 C_HEADERS(IsoOrderedGenerator)
 
 
+//______________________________________________________MULTITHREADED THRESHOLD GENERATOR
+// The marginals shared by the generators of one multithreaded enumeration (using
+// up those of iso). Each thread sets up its own generator from them; together
+// they produce every configuration above the threshold once, each taking whole
+// slices in turn. The generators have to be deleted before the marginals, and
+// keep no memory accounts (memoryUsed/memoryPeak give 0).
+void* setupThresholdMTMarginals(void* iso,
+                                double threshold,
+                                bool _absolute,
+                                int _tabSize,
+                                int _hashSize);
+void deleteThresholdMTMarginals(void* marginals);
+void* setupIsoThresholdGeneratorMT(void* marginals);
+C_HEADERS(IsoThresholdGeneratorMT)
+
+
+
+#define C_TABULATOR_HEADERS(tabulatorName)\
+void delete##tabulatorName(void* tabulator);\
+const double* masses##tabulatorName(void* tabulator);\
+const double* lprobs##tabulatorName(void* tabulator);\
+const double* probs##tabulatorName(void* tabulator);\
+const int*    confs##tabulatorName(void* tabulator);\
+size_t confs_no##tabulatorName(void* tabulator);\
+int confs_dim##tabulatorName(void* tabulator);\
+void get_conf_signature##tabulatorName(void* tabulator, size_t idx, int* space);
+
 
 // Check if there is bool in CFFI
+// With compress_confs set, confs hold confs_dim (the number of elements) marginal
+// indices per configuration, which get_conf_signature expands. The generator must
+// then outlive the tabulator (the multithreaded one keeps what it needs itself).
+// The tabulator setups return NULL if the computation fails (e.g. memory or the
+// memory budget runs out).
 void* setupThresholdTabulator(void* generator,
                               bool  get_masses,
                               bool  get_probs,
                               bool  get_lprobs,
-                              bool  get_confs);
+                              bool  get_confs,
+                              bool  compress_confs);
+C_TABULATOR_HEADERS(ThresholdTabulator)
+
+
+void* setupLayeredTabulator(void* generator,
+                            double target_total_prob,
+                            bool  optimize,
+                            bool  get_masses,
+                            bool  get_probs,
+                            bool  get_lprobs,
+                            bool  get_confs,
+                            bool  compress_confs);
+C_TABULATOR_HEADERS(LayeredTabulator)
+double total_probLayeredTabulator(void* tabulator);
+
+
+void* setupOrderedTabulator(void* generator,
+                            double target_total_prob,
+                            bool  get_masses,
+                            bool  get_probs,
+                            bool  get_lprobs,
+                            bool  get_confs,
+                            bool  compress_confs);
+C_TABULATOR_HEADERS(OrderedTabulator)
+double total_probOrderedTabulator(void* tabulator);
+
+
+// Uses up the marginals of iso; n_threads == 0 means one per processor
+void* setupThresholdTabulatorMT(void* iso,
+                                double threshold,
+                                bool  _absolute,
+                                int   n_threads,
+                                bool  get_masses,
+                                bool  get_probs,
+                                bool  get_lprobs,
+                                bool  get_confs,
+                                bool  compress_confs,
+                                int   _tabSize,
+                                int   _hashSize);
+C_TABULATOR_HEADERS(ThresholdTabulatorMT)
+
+// Threshold tabulation of molecules_no molecules in n_threads, given as formulas
+// or as rows of atomCounts over the same elements (see setupIso). Results are
+// concatenated: those of molecule ii are at offsets[ii] .. offsets[ii+1], and
+// its confs start at conf_offsets[ii]. Returns NULL if a formula or a row of counts
+// is invalid, or if memory runs out.
+void* setupBatchThresholdTabulator(const char* const* formulas,
+                                   size_t molecules_no,
+                                   double threshold,
+                                   bool  _absolute,
+                                   int   n_threads,
+                                   bool  get_masses,
+                                   bool  get_probs,
+                                   bool  get_lprobs,
+                                   bool  get_confs);
+void* setupBatchThresholdTabulatorFromCounts(size_t molecules_no,
+                                             int dimNumber,
+                                             const int* isotopeNumbers,
+                                             const int* atomCounts,
+                                             const double* isotopeMasses,
+                                             const double* isotopeProbabilities,
+                                             double threshold,
+                                             bool  _absolute,
+                                             int   n_threads,
+                                             bool  get_masses,
+                                             bool  get_probs,
+                                             bool  get_lprobs,
+                                             bool  get_confs);
+void deleteBatchThresholdTabulator(void* tabulator);
+const double* massesBatchThresholdTabulator(void* tabulator);
+const double* lprobsBatchThresholdTabulator(void* tabulator);
+const double* probsBatchThresholdTabulator(void* tabulator);
+const int*    confsBatchThresholdTabulator(void* tabulator);
+const size_t* offsetsBatchThresholdTabulator(void* tabulator);
+const size_t* conf_offsetsBatchThresholdTabulator(void* tabulator);
+size_t confs_noBatchThresholdTabulator(void* tabulator);
+
+// Binned spectrum computed in n_threads (0: one per processor); also uses up
+// the marginals of iso. The whole computation happens in setupSpectrum, which
+// returns NULL if it fails.
+void* setupSpectrum(void* iso,
+                    double bucket_width,
+                    double threshold,
+                    bool  _absolute,
+                    int   n_threads);
+void deleteSpectrum(void* spectrum);
+const double* bucketsSpectrum(void* spectrum);
+long long n_bucketsSpectrum(void* spectrum);
+double first_bucket_massSpectrum(void* spectrum);
+long long total_confsSpectrum(void* spectrum);
+double total_probSpectrum(void* spectrum);
+
+// Writes all the configurations from the generator into a file (see FileTabulator
+// in tabulator.h for the format). Returns their number, or -1 if writing failed
+// (or anything else did, such as running out of memory).
+#define C_HEADER_TABULATE_TO_FILE(generatorType)\
+long long tabulateToFile##generatorType(void* generator, const char* path,\
+                                        bool get_masses, bool get_probs,\
+                                        bool get_lprobs, bool get_confs);
+
+C_HEADER_TABULATE_TO_FILE(IsoThresholdGenerator)
+C_HEADER_TABULATE_TO_FILE(IsoLayeredGenerator)
+C_HEADER_TABULATE_TO_FILE(IsoOrderedGenerator)
 
-void deleteThresholdTabulator(void* tabulator);
+// Same, in the Apache Arrow IPC format: a stream, or a file if file_format is set.
+#define C_HEADER_WRITE_ARROW(generatorType)\
+long long writeArrow##generatorType(void* generator, const char* path, bool file_format,\
+                                    bool get_masses, bool get_probs,\
+                                    bool get_lprobs, bool get_confs);
 
-const double* massesThresholdTabulator(void* tabulator);
-const double* lprobsThresholdTabulator(void* tabulator);
-const double* probsThresholdTabulator(void* tabulator);
-const int*    confsThresholdTabulator(void* tabulator);
-int confs_noThresholdTabulator(void* tabulator);
+C_HEADER_WRITE_ARROW(IsoThresholdGenerator)
+C_HEADER_WRITE_ARROW(IsoLayeredGenerator)
+C_HEADER_WRITE_ARROW(IsoOrderedGenerator)
 
 #ifdef __cplusplus
 }
@@ -17,34 +17,50 @@
 
 #include <iostream>
 #include <stdlib.h>
+#include <algorithm>
+#include "allocator.h"
 #include "dirtyAllocator.h"
 
 
 DirtyAllocator::DirtyAllocator(
-    const int dim, const int tabSize
-): tabSize(tabSize)
+    const int dim, const int tabSize, MemoryResource* resource
+): tabSize(tabSize), resource(resource)
 {
     cellSize        = sizeof(double) + sizeof(int) * dim;
     // Fix memory alignment problems for SPARC
     if(cellSize % sizeof(double) != 0)
     	cellSize += sizeof(double) - cellSize % sizeof(double);
-    currentTab      = malloc( cellSize * tabSize );
+    maxTabSize      = std::max<int>(tabSize, ALLOCATOR_MAX_PAGE_BYTES / cellSize);
+    currentTab      = resource->allocate( static_cast<size_t>(cellSize) * tabSize, sizeof(double) );
     currentConf     = currentTab;
-    endOfTablePtr = reinterpret_cast<char*>(currentTab) + cellSize*tabSize;
+    endOfTablePtr = reinterpret_cast<char*>(currentTab) + static_cast<size_t>(cellSize)*tabSize;
 }
 
 
 DirtyAllocator::~DirtyAllocator()
 {
-    for(unsigned int i = 0; i < prevTabs.size(); ++i) free(prevTabs[i]);
-    free(currentTab);
+    for(unsigned int i = 0; i < prevTabs.size(); ++i)
+        resource->deallocate(prevTabs[i].first, static_cast<size_t>(cellSize) * prevTabs[i].second, sizeof(double));
+    resource->deallocate(currentTab, static_cast<size_t>(cellSize) * tabSize, sizeof(double));
 }
 
 void DirtyAllocator::shiftTables()
 {
-    prevTabs.push_back(currentTab);
+    const int newSize = next_page_size(tabSize, maxTabSize);
 
-    currentTab              = malloc( cellSize * tabSize );
+    // If the resource throws (e.g. a MemoryBudget), the allocator stays as it was
+    prevTabs.push_back(std::make_pair(currentTab, tabSize));
+    try
+    {
+        currentTab          = resource->allocate( static_cast<size_t>(cellSize) * newSize, sizeof(double) );
+    }
+    catch(...)
+    {
+        prevTabs.pop_back();
+        throw;
+    }
+
+    tabSize                 = newSize;
     currentConf             = currentTab;
-    endOfTablePtr   = reinterpret_cast<char*>(currentTab) + cellSize*tabSize;
+    endOfTablePtr   = reinterpret_cast<char*>(currentTab) + static_cast<size_t>(cellSize)*tabSize;
 }
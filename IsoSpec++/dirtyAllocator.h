@@ -19,19 +19,23 @@
 #define DIRTY_ALLOCATOR_HPP
 
 #include <vector>
+#include <utility>
 #include <iostream>
 #include <string.h>
+#include "arena.h"
 
 class DirtyAllocator{
 private:
     void*   currentTab;
     void*   currentConf;
     void*   endOfTablePtr;
-    const int       tabSize;
+    int     tabSize;                                // of the current page, as in Allocator
+    int     maxTabSize;
     int     cellSize;
-    std::vector<void*>  prevTabs;
+    std::vector<std::pair<void*, int> >  prevTabs;   // with their sizes
+    MemoryResource* const resource;
 public:
-    DirtyAllocator(const int dim, const int tabSize = 10000);
+    DirtyAllocator(const int dim, const int tabSize = 10000, MemoryResource* resource = default_memory_resource());
     ~DirtyAllocator();
 
     void shiftTables();
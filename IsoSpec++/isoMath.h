@@ -24,12 +24,24 @@
 #define G_FACT_TABLE_SIZE 1024*1024*10
 extern double* g_lfact_table;
 
+// lgamma sets the global signgam, which is a data race when marginals are
+// built in several threads at once
+static inline double iso_lgamma(double x)
+{
+#if defined(_WIN32)
+    return lgamma(x);
+#else
+    int sign;
+    return lgamma_r(x, &sign);
+#endif
+}
+
 static inline double minuslogFactorial(int n) 
 { 
     if (n < 2) 
         return 0.0;
     if (g_lfact_table[n] == 0.0)
-        g_lfact_table[n] = -lgamma(n+1);
+        g_lfact_table[n] = -iso_lgamma(n+1);
 
     return g_lfact_table[n];
 }
@@ -28,6 +28,7 @@
 #include <iomanip>
 #include <cctype>
 #include <stdexcept>
+#include <functional>
 #include <string>
 #include <limits>
 #include <assert.h>
@@ -40,38 +41,165 @@
 #include "isoSpec++.h"
 #include "misc.h"
 #include "element_tables.h"
+#include "isotopeLabels.h"
 
 
 using namespace std;
 
+// Every Iso keeps accounts of the memory it takes from the given resource
+static inline MemoryAccounting* new_accounting(MemoryResource* upstream)
+{
+    if(upstream == nullptr)
+        upstream = huge_pages() ? huge_page_resource() : default_memory_resource();
+    return resource_construct<MemoryAccounting>(upstream, upstream);
+}
+
 Iso::Iso(
     int             _dimNumber,
     const int*      _isotopeNumbers,
     const int*      _atomCounts,
     const double* const *  _isotopeMasses,
-    const double* const *  _isotopeProbabilities
+    const double* const *  _isotopeProbabilities,
+    MemoryResource* _resource
 ) :
 disowned(false),
-dimNumber(_dimNumber),
-isotopeNumbers(array_copy<int>(_isotopeNumbers, _dimNumber)),
-atomCounts(array_copy<int>(_atomCounts, _dimNumber)),
-confSize(_dimNumber * sizeof(int)),
+accounting(new_accounting(_resource)),
+resource(accounting),
+dimNumber(0),
+isotopeNumbers(nullptr),
+atomCounts(nullptr),
+confSize(0),
 allDim(0),
 marginals(nullptr),
-modeLProb(0.0)
+modeLProb(0.0),
+rowsNumber(_dimNumber),
+rowMarginals(nullptr),
+rowAtomCounts(nullptr)
 {
-	setupMarginals(_isotopeMasses, _isotopeProbabilities);
+    try
+    {
+        isotopeNumbers = resource_new<int>(resource, _dimNumber);
+        atomCounts = resource_new<int>(resource, _dimNumber);
+        setupRows(_isotopeNumbers, _atomCounts, _isotopeMasses, _isotopeProbabilities);
+    }
+    catch(...)
+    {
+        release();
+        throw;
+    }
+}
+
+Iso::Iso(
+    int             _dimNumber,
+    const int*      _atomicNumbers,
+    const int*      _atomCounts,
+    MemoryResource* _resource
+) :
+disowned(false),
+accounting(new_accounting(_resource)),
+resource(accounting),
+dimNumber(0),
+isotopeNumbers(nullptr),
+atomCounts(nullptr),
+confSize(0),
+allDim(0),
+marginals(nullptr),
+modeLProb(0.0),
+rowsNumber(_dimNumber),
+rowMarginals(nullptr),
+rowAtomCounts(nullptr)
+{
+    try
+    {
+        std::vector<int> isoNumbers(_dimNumber);
+        std::vector<const double*> masses(_dimNumber);
+        std::vector<const double*> probs(_dimNumber);
+
+        for(int row=0; row<_dimNumber; row++)
+        {
+            const int first = find_element_by_atomic_number(_atomicNumbers[row], &isoNumbers[row]);
+            if(first < 0)
+                throw invalid_argument("Unknown element");
+            masses[row] = &elem_table_mass[first];
+            probs[row] = &elem_table_probability[first];
+        }
+
+        isotopeNumbers = resource_new<int>(resource, _dimNumber);
+        atomCounts = resource_new<int>(resource, _dimNumber);
+        setupRows(isoNumbers.data(), _atomCounts, masses.data(), probs.data());
+    }
+    catch(...)
+    {
+        release();
+        throw;
+    }
+}
+
+void Iso::setupRows(const int* _isotopeNumbers, const int* _atomCounts,
+                    const double* const * _isotopeMasses, const double* const * _isotopeProbabilities)
+{
+    std::vector<const double*> masses;
+    std::vector<const double*> probs;
+    // Freed by release() if this throws
+    rowMarginals = resource_new<int>(resource, rowsNumber);
+    rowAtomCounts = resource_copy<int>(resource, _atomCounts, rowsNumber);
+
+    for(int row=0; row<rowsNumber; row++)
+    {
+        const int isoNo = _isotopeNumbers[row];
+        int ii = 0;
+        while(ii < dimNumber and not (isotopeNumbers[ii] == isoNo and
+                                      memcmp(masses[ii], _isotopeMasses[row], isoNo*sizeof(double)) == 0 and
+                                      memcmp(probs[ii], _isotopeProbabilities[row], isoNo*sizeof(double)) == 0))
+            ii++;
+
+        if(ii == dimNumber)
+        {
+            isotopeNumbers[ii] = isoNo;
+            atomCounts[ii] = _atomCounts[row];
+            masses.push_back(_isotopeMasses[row]);
+            probs.push_back(_isotopeProbabilities[row]);
+            dimNumber++;
+        }
+        else
+        {
+            if(atomCounts[ii] > std::numeric_limits<int>::max() - _atomCounts[row])
+                throw invalid_argument("Too many atoms");
+            atomCounts[ii] += _atomCounts[row];
+        }
+        rowMarginals[row] = ii;
+    }
+
+    if(dimNumber == rowsNumber)
+    {
+        resource_delete(resource, rowMarginals, rowsNumber);
+        resource_delete(resource, rowAtomCounts, rowsNumber);
+        rowMarginals = rowAtomCounts = nullptr;
+    }
+    confSize = dimNumber * sizeof(int);
+
+    setupMarginals(masses.data(), probs.data());
+
+    // Signatures keep the layout of the rows as given
+    allDim = 0;
+    for(int row=0; row<rowsNumber; row++)
+        allDim += _isotopeNumbers[row];
 }
 
 Iso::Iso(Iso&& other) :
 disowned(other.disowned),
+accounting(other.accounting),
+resource(other.resource),
 dimNumber(other.dimNumber),
 isotopeNumbers(other.isotopeNumbers),
 atomCounts(other.atomCounts),
 confSize(other.confSize),
 allDim(other.allDim),
 marginals(other.marginals),
-modeLProb(other.modeLProb)
+modeLProb(other.modeLProb),
+rowsNumber(other.rowsNumber),
+rowMarginals(other.rowMarginals),
+rowAtomCounts(other.rowAtomCounts)
 {
     other.disowned = true;
 }
@@ -79,29 +207,48 @@ modeLProb(other.modeLProb)
 
 Iso::Iso(const Iso& other, bool fullcopy) :
 disowned(fullcopy ? throw std::logic_error("Not implemented") : true),
+accounting(nullptr),
+resource(default_memory_resource()),
 dimNumber(other.dimNumber),
 isotopeNumbers(fullcopy ? array_copy<int>(other.isotopeNumbers, dimNumber) : other.isotopeNumbers),
 atomCounts(fullcopy ? array_copy<int>(other.atomCounts, dimNumber) : other.atomCounts),
 confSize(other.confSize),
 allDim(other.allDim),
 marginals(fullcopy ? throw std::logic_error("Not implemented") : other.marginals),
-modeLProb(other.modeLProb)
+modeLProb(other.modeLProb),
+rowsNumber(other.rowsNumber),
+rowMarginals(other.rowMarginals),
+rowAtomCounts(other.rowAtomCounts)
 {}
 
 
+// Probabilities taken straight from the element tables come with precomputed
+// logarithms; for anything else they have to be looked up (see getMLogProbs)
+static inline const double* table_lprobs(const double* probs)
+{
+    const std::less<const double*> before;
+    if(before(probs, elem_table_probability) or not before(probs, elem_table_probability + NUMBER_OF_ISOTOPIC_ENTRIES))
+        return nullptr;
+    return elem_table_log_probability + (probs - elem_table_probability);
+}
+
 inline void Iso::setupMarginals(const double* const * _isotopeMasses, const double* const * _isotopeProbabilities)
 {
     if (marginals == nullptr)
     {
-        marginals = new Marginal*[dimNumber];
+        marginals = resource_new<Marginal*>(resource, dimNumber);
+        for(int i=0; i<dimNumber;i++)
+            marginals[i] = nullptr;
         for(int i=0; i<dimNumber;i++)
         {
         allDim += isotopeNumbers[i];
-        marginals[i] = new Marginal(
+        marginals[i] = resource_construct<Marginal>(resource,
                 _isotopeMasses[i],
                 _isotopeProbabilities[i],
                 isotopeNumbers[i],
-                atomCounts[i]
+                atomCounts[i],
+                table_lprobs(_isotopeProbabilities[i]),
+                resource
             );
             modeLProb += marginals[i]->getModeLProb();
         }
@@ -112,12 +259,19 @@ inline void Iso::setupMarginals(const double* const * _isotopeMasses, const doub
 Iso::~Iso()
 {
     if(not disowned)
-    {
+        release();
+}
+
+// Also cleans up after constructors that throw half way through
+void Iso::release()
+{
     if (marginals != nullptr)
-        dealloc_table(marginals, dimNumber);
-    delete[] isotopeNumbers;
-    delete[] atomCounts;
-    }
+        dealloc_table(resource, marginals, dimNumber);
+    resource_delete(resource, isotopeNumbers, rowsNumber);
+    resource_delete(resource, atomCounts, rowsNumber);
+    resource_delete(resource, rowMarginals, rowsNumber);
+    resource_delete(resource, rowAtomCounts, rowsNumber);
+    resource_destroy(accounting->get_upstream(), accounting);
 }
 
 
@@ -139,110 +293,200 @@ double Iso::getHeaviestPeakMass() const
 
 
 
-inline int str_to_int(const string& s)
-{
-    char* endptr[1];
-    const char* c_s = s.c_str();
-    int ret = (int) strtol(c_s, endptr, 10);
-    if (c_s == endptr[0])
-        throw invalid_argument("Invalid formula");
-    return ret;
-}
-
-Iso::Iso(const char* formula) :
+Iso::Iso(const char* formula, MemoryResource* _resource) :
 disowned(false),
+accounting(new_accounting(_resource)),
+resource(accounting),
+dimNumber(0),
+isotopeNumbers(nullptr),
+atomCounts(nullptr),
+allDim(0),
 marginals(nullptr),
-modeLProb(0.0)
+modeLProb(0.0),
+rowsNumber(0),
+rowMarginals(nullptr),
+rowAtomCounts(nullptr)
 {
     std::vector<const double*> isotope_masses;
     std::vector<const double*> isotope_probabilities;
 
-    dimNumber = parse_formula(formula, isotope_masses, isotope_probabilities, &isotopeNumbers, &atomCounts, &confSize);
-
-    setupMarginals(isotope_masses.data(), isotope_probabilities.data());
+    try
+    {
+        dimNumber = parse_formula(formula, isotope_masses, isotope_probabilities, &isotopeNumbers, &atomCounts, &confSize, resource);
+        rowsNumber = dimNumber;
+        setupMarginals(isotope_masses.data(), isotope_probabilities.data());
+    }
+    catch(...)
+    {
+        release();
+        throw;
+    }
 }
 
-unsigned int parse_formula(const char* formula, std::vector<const double*>& isotope_masses, std::vector<const double*>& isotope_probabilities, int** isotopeNumbers, int** atomCounts, unsigned int* confSize)
+#define MAX_FORMULA_NESTING 64
+#define MAX_FORMULA_ELEMENTS 128
+
+static inline bool is_digit(char c) { return c >= '0' and c <= '9'; }
+static inline bool is_upper(char c) { return c >= 'A' and c <= 'Z'; }
+static inline bool is_lower(char c) { return c >= 'a' and c <= 'z'; }
+static inline bool is_space(char c) { return c == ' ' or c == '\t' or c == '\n' or c == '\r'; }
+
+/*
+ * Formulas are read right to left, so that the multiplier of a parenthesised group
+ * is known before its contents, and the counts can be accumulated straight away
+ * without allocating anything. Counts default to 1, whitespace between tokens is
+ * ignored, and repeated elements are merged, ordered by their first appearance.
+ * An element may carry an isotope label in brackets: C[13C=0.99]6 or C[SILAC]6
+ * (see isotopeLabels.h); labelled and natural atoms are separate elements.
+ */
+unsigned int parse_formula(const char* formula, std::vector<const double*>& isotope_masses, std::vector<const double*>& isotope_probabilities, int** isotopeNumbers, int** atomCounts, unsigned int* confSize, MemoryResource* resource)
 {
-// This function is NOT guaranteed to be secure against malicious input. It should be used only for debugging.
+    if(formula == nullptr)
+        throw invalid_argument("Invalid formula");
 
-    string cpp_formula(formula);
-    int last_modeswitch = 0;
-    int mode = 0;
-    int pos = 0;
-    std::vector<string> elements;
-    std::vector<int> numbers;
-    while(formula[pos] != '\0')
+    struct Found
     {
-        if(isdigit(formula[pos]) && mode == 0)
-        {
-            elements.push_back(cpp_formula.substr(last_modeswitch, pos-last_modeswitch));
-            last_modeswitch = pos;
-            mode = 1;
-        }
-        else if(isalpha(formula[pos]) && mode == 1)
-        {
-            numbers.push_back(str_to_int(cpp_formula.substr(last_modeswitch, pos-last_modeswitch)));
-            last_modeswitch = pos;
-            mode = 0;
-        }
-        pos++;
-    }
+        const char* position;
+        int first;
+        int isotope_no;
+        const double* probs;
+        long long count;
+    };
 
-    numbers.push_back(str_to_int(cpp_formula.substr(last_modeswitch, pos)));
+    Found found[MAX_FORMULA_ELEMENTS];
+    unsigned int dimNumber = 0;
 
+    long long multipliers[MAX_FORMULA_NESTING+1];
+    int depth = 0;
+    multipliers[0] = 1;
+    long long pending = -1;     // number waiting for its element or group
 
-    if(elements.size() != numbers.size())
-        throw invalid_argument("Invalid formula");
+    const char* p = formula + strlen(formula);
 
-    std::vector<int> element_indexes;
-
-    for (unsigned int i=0; i<elements.size(); i++)
+    while(p > formula)
     {
-        int idx = -1;
-        for(int j=0; j<NUMBER_OF_ISOTOPIC_ENTRIES; j++)
+        const char c = *--p;
+
+        if(is_space(c))
+            continue;
+
+        if(is_digit(c))
         {
-            if (elements[i].compare(elem_table_symbol[j]) == 0)
+            if(pending >= 0)
+                throw invalid_argument("Invalid formula");
+            const char* end = p+1;
+            while(p > formula and is_digit(p[-1]))
+                p--;
+            pending = 0;
+            for(const char* d = p; d < end; d++)
             {
-                idx = j;
-                break;
+                pending = pending*10 + (*d - '0');
+                if(pending > std::numeric_limits<int>::max())
+                    throw invalid_argument("Invalid formula");
             }
         }
-        if(idx < 0)
-            throw invalid_argument("Invalid formula");
-        element_indexes.push_back(idx);
+        else if(c == ')')
+        {
+            if(depth == MAX_FORMULA_NESTING)
+                throw invalid_argument("Invalid formula");
+            multipliers[depth+1] = multipliers[depth] * (pending >= 0 ? pending : 1);
+            if(multipliers[depth+1] > std::numeric_limits<int>::max())
+                throw invalid_argument("Invalid formula");
+            depth++;
+            pending = -1;
+        }
+        else if(c == '(')
+        {
+            if(depth == 0 or pending >= 0)
+                throw invalid_argument("Invalid formula");
+            depth--;
+        }
+        else if(is_upper(c) or is_lower(c) or c == ']')
+        {
+            const char* label = nullptr;
+            size_t label_length = 0;
+            if(c == ']')
+            {
+                const char* label_end = p;
+                while(p > formula and p[-1] != '[' and p[-1] != ']')
+                    p--;
+                if(p == formula or p[-1] != '[' or p-1 == formula)
+                    throw invalid_argument("Invalid formula");
+                label = p;
+                label_length = label_end - p;
+                p--;
+                if(not is_upper(p[-1]) and not is_lower(p[-1]))
+                    throw invalid_argument("Invalid formula");
+                --p;
+            }
 
-    }
+            const char* symbol = p;
+            if(is_lower(*p))
+            {
+                if(p == formula or not is_upper(p[-1]))
+                    throw invalid_argument("Invalid formula");
+                symbol = --p;
+            }
 
-    vector<int> _isotope_numbers;
+            int isotope_no;
+            const int first = find_element(symbol, is_lower(symbol[1]) ? 2 : 1, &isotope_no);
+            if(first < 0)
+                throw invalid_argument("Invalid formula");
+            const double* probs = label == nullptr ? &elem_table_probability[first]
+                                                   : labelled_probabilities(first, label, label_length);
+
+            unsigned int ii = 0;
+            while(ii < dimNumber and found[ii].probs != probs)
+                ii++;
+            if(ii == dimNumber)
+            {
+                if(dimNumber == MAX_FORMULA_ELEMENTS)
+                    throw invalid_argument("Invalid formula");
+                found[ii].first = first;
+                found[ii].isotope_no = isotope_no;
+                found[ii].probs = probs;
+                found[ii].count = 0;
+                dimNumber++;
+            }
 
-    for(vector<int>::iterator it = element_indexes.begin(); it != element_indexes.end(); ++it)
-    {
-        int num = 0;
-        int at_idx = *it;
-        int atomicNo = elem_table_atomicNo[at_idx];
-        while(at_idx < NUMBER_OF_ISOTOPIC_ENTRIES && elem_table_atomicNo[at_idx] == atomicNo)
-        {
-            at_idx++;
-            num++;
+            found[ii].count += (pending >= 0 ? pending : 1) * multipliers[depth];
+            if(found[ii].count > std::numeric_limits<int>::max())
+                throw invalid_argument("Invalid formula");
+            found[ii].position = p;
+            pending = -1;
         }
-        _isotope_numbers.push_back(num);
+        else
+            throw invalid_argument("Invalid formula");
     }
 
-    for(vector<int>::iterator it = element_indexes.begin(); it != element_indexes.end(); ++it)
-    {
-        isotope_masses.push_back(&elem_table_mass[*it]);
-        isotope_probabilities.push_back(&elem_table_probability[*it]);
-    };
+    if(pending >= 0 or depth != 0 or dimNumber == 0)
+        throw invalid_argument("Invalid formula");
 
-    const unsigned int dimNumber = elements.size();
+    std::sort(found, found + dimNumber, [](const Found& a, const Found& b) { return a.position < b.position; });
 
-    *isotopeNumbers = array_copy<int>(_isotope_numbers.data(), dimNumber);
-    *atomCounts = array_copy<int>(numbers.data(), dimNumber);
+    isotope_masses.reserve(dimNumber);
+    isotope_probabilities.reserve(dimNumber);
+    *isotopeNumbers = resource_new<int>(resource, dimNumber);
+    try
+    {
+        *atomCounts = resource_new<int>(resource, dimNumber);
+    }
+    catch(...)
+    {
+        resource_delete(resource, *isotopeNumbers, dimNumber);
+        *isotopeNumbers = nullptr;     // Iso's constructor cleans up whatever is set
+        throw;
+    }
+    for(unsigned int ii=0; ii<dimNumber; ii++)
+    {
+        isotope_masses.push_back(&elem_table_mass[found[ii].first]);
+        isotope_probabilities.push_back(found[ii].probs);
+        (*isotopeNumbers)[ii] = found[ii].isotope_no;
+        (*atomCounts)[ii] = found[ii].count;
+    }
     *confSize = dimNumber * sizeof(int);
 
     return dimNumber;
-
 }
 
 
@@ -254,10 +498,23 @@ unsigned int parse_formula(const char* formula, std::vector<const double*>& isot
 
 IsoGenerator::IsoGenerator(Iso&& iso) :
     Iso(std::move(iso)),
-    partialLProbs(new double[dimNumber+1+PADDING]),
-    partialMasses(new double[dimNumber+1+PADDING]),
-    partialExpProbs(new double[dimNumber+1+PADDING])
+    generator_resource(resource->component(MEMORY_GENERATOR)),
+    partialLProbs(nullptr),
+    partialMasses(nullptr),
+    partialExpProbs(nullptr)
 {
+    try
+    {
+        partialLProbs = resource_new<double>(generator_resource, dimNumber+1+PADDING);
+        partialMasses = resource_new<double>(generator_resource, dimNumber+1+PADDING);
+        partialExpProbs = resource_new<double>(generator_resource, dimNumber+1+PADDING);
+    }
+    catch(...)
+    {
+        resource_delete(generator_resource, partialLProbs, dimNumber+1+PADDING);
+        resource_delete(generator_resource, partialMasses, dimNumber+1+PADDING);
+        throw;
+    }
     partialLProbs[dimNumber] = 0.0;
     partialMasses[dimNumber] = 0.0;
     partialExpProbs[dimNumber] = 1.0;
@@ -267,11 +524,11 @@ IsoGenerator::IsoGenerator(Iso&& iso) :
 IsoGenerator::~IsoGenerator() 
 {
     if(partialLProbs != nullptr)
-        delete[] partialLProbs; 
+        resource_delete(generator_resource, partialLProbs, dimNumber+1+PADDING);
     if(partialMasses != nullptr)
-        delete[] partialMasses; 
+        resource_delete(generator_resource, partialMasses, dimNumber+1+PADDING);
     if(partialExpProbs != nullptr)
-        delete[] partialExpProbs; 
+        resource_delete(generator_resource, partialExpProbs, dimNumber+1+PADDING);
 }
 
 
@@ -285,38 +542,69 @@ IsoGenerator::~IsoGenerator()
 
 PrecalculatedMarginal** Iso::get_MT_marginal_set(double Lcutoff, bool absolute, int tabSize, int hashSize)
 {
-    PrecalculatedMarginal** ret = new PrecalculatedMarginal*[dimNumber];
+    MemoryResource* const mt_resource = resource->component(MEMORY_GENERATOR);
+    PrecalculatedMarginal** ret = resource_new<PrecalculatedMarginal*>(mt_resource, dimNumber);
+    for(int ii = 0; ii<dimNumber; ii++)
+        ret[ii] = nullptr;
 
     if(absolute)
         Lcutoff -= modeLProb;
 
-    for(int ii = 0; ii<dimNumber - 1; ii++)
-        ret[ii] = new PrecalculatedMarginal(std::move(*(marginals[ii])),
-                                            Lcutoff + marginals[ii]->getModeLProb(),
-                                            true,
-                                            tabSize,
-                                            hashSize);
-
-
-    const unsigned int ii = dimNumber - 1;
-    ret[ii] = new SyncMarginal(std::move(*(marginals[ii])),
-                            Lcutoff + marginals[ii]->getModeLProb(),
-                            tabSize,
-                            hashSize);
+    try
+    {
+        for(int ii = 0; ii<dimNumber - 1; ii++)
+            ret[ii] = resource_construct<PrecalculatedMarginal>(mt_resource,
+                                                std::move(*(marginals[ii])),
+                                                Lcutoff + marginals[ii]->getModeLProb(),
+                                                true,
+                                                tabSize,
+                                                hashSize);
+
+
+        const unsigned int ii = dimNumber - 1;
+        ret[ii] = resource_construct<SyncMarginal>(mt_resource,
+                                std::move(*(marginals[ii])),
+                                Lcutoff + marginals[ii]->getModeLProb(),
+                                tabSize,
+                                hashSize);
+    }
+    catch(...)
+    {
+        free_MT_marginal_set(ret);
+        throw;
+    }
     return ret;
 }
 
+void Iso::free_MT_marginal_set(PrecalculatedMarginal** PMs)
+{
+    MemoryResource* const mt_resource = resource->component(MEMORY_GENERATOR);
+    for(int ii = 0; ii<dimNumber - 1; ii++)
+        resource_destroy(mt_resource, PMs[ii]);
+    // Given back with its own size
+    resource_destroy(mt_resource, static_cast<SyncMarginal*>(PMs[dimNumber-1]));
+    resource_delete(mt_resource, PMs, dimNumber);
+}
+
 
 IsoThresholdGeneratorMT::IsoThresholdGeneratorMT(Iso&& iso, double _threshold, PrecalculatedMarginal** PMs, bool _absolute)
 : IsoGenerator(Iso(iso, false)),
 Lcutoff(_threshold <= 0.0 ? std::numeric_limits<double>::lowest() : (_absolute ? log(_threshold) : log(_threshold) + modeLProb)),
 last_marginal(static_cast<SyncMarginal*>(PMs[dimNumber-1]))
 {
-    counter = new unsigned int[dimNumber+PADDING];
-    maxConfsLPSum = new double[dimNumber-1];
+    counter = resource_new<unsigned int>(generator_resource, dimNumber+PADDING);
+    maxConfsLPSum = resource_new<double>(generator_resource, dimNumber);
 
     marginalResults = PMs;
 
+    if(dimNumber == 1)
+    {
+        // Nothing to iterate over locally: every configuration is taken
+        // straight from the shared marginal in advanceToNextConfiguration
+        counter[0] = 0;
+        return;
+    }
+
     bool empty = false;
     for(int ii=0; ii<dimNumber-1; ii++)
     {
@@ -326,7 +614,6 @@ last_marginal(static_cast<SyncMarginal*>(PMs[dimNumber-1]))
             empty = true;
     }
 
-    marginalResults[dimNumber-1] = last_marginal;
     counter[dimNumber-1] = last_marginal->getNextConfIdx();
     if(not last_marginal->inRange(counter[dimNumber-1]))
         empty = true;
@@ -346,8 +633,27 @@ last_marginal(static_cast<SyncMarginal*>(PMs[dimNumber-1]))
         terminate_search();
 }
 
+IsoThresholdGeneratorMT::~IsoThresholdGeneratorMT()
+{
+    resource_delete(generator_resource, counter, dimNumber+PADDING);
+    resource_delete(generator_resource, maxConfsLPSum, dimNumber);
+}
+
 bool IsoThresholdGeneratorMT::advanceToNextConfiguration()
 {
+    if(dimNumber == 1)
+    {
+        counter[0] = last_marginal->getNextConfIdx();
+        if(last_marginal->inRange(counter[0]))
+        {
+            partialLProbs[0] = last_marginal->get_lProb(counter[0]);
+            partialMasses[0] = last_marginal->get_mass(counter[0]);
+            partialExpProbs[0] = last_marginal->get_eProb(counter[0]);
+            return true;
+        }
+        return false;
+    }
+
     counter[0]++;
     partialLProbs[0] = partialLProbs[1] + marginalResults[0]->get_lProb(counter[0]);
     if(partialLProbs[0] >= Lcutoff)
@@ -396,8 +702,59 @@ bool IsoThresholdGeneratorMT::advanceToNextConfiguration()
 
 void IsoThresholdGeneratorMT::terminate_search()
 {
+    // Same as in IsoThresholdGenerator: further advances fail on the guardians
     for(int ii=0; ii<dimNumber; ii++)
-        counter[ii] = marginalResults[ii]->get_no_confs();
+    {
+        counter[ii] = marginalResults[ii]->get_no_confs()-1;
+        partialLProbs[ii] = -std::numeric_limits<double>::infinity();
+    }
+    partialLProbs[dimNumber] = -std::numeric_limits<double>::infinity();
+}
+
+size_t IsoThresholdGeneratorMT::count_slice(unsigned int slice)
+{
+    const int last = dimNumber-1;
+
+    if(not marginalResults[last]->inRange(slice))
+        return 0;
+
+    // The shared marginal holds only configurations above the threshold
+    if(dimNumber == 1)
+        return 1;
+
+    // Same walk as in IsoThresholdGenerator::count_confs, with the last counter fixed
+    const double* lProbs0 = marginalResults[0]->get_lProbs_ptr();
+    const unsigned int no_confs0 = marginalResults[0]->get_no_confs();
+    size_t count = 0;
+
+    memset(counter, 0, last * sizeof(unsigned int));
+    partialLProbs[last] = marginalResults[last]->get_lProb(slice);
+    for(int ii=last-1; ii>0; ii--)
+        partialLProbs[ii] = partialLProbs[ii+1] + marginalResults[ii]->get_lProb(0);
+
+    while(true)
+    {
+        count += count_above_cutoff(lProbs0, no_confs0, partialLProbs[1], Lcutoff);
+
+        int idx = 1;
+        while(true)
+        {
+            if(idx >= last)
+            {
+                terminate_search();
+                return count;
+            }
+            counter[idx]++;
+            partialLProbs[idx] = partialLProbs[idx+1] + marginalResults[idx]->get_lProb(counter[idx]);
+            if(partialLProbs[idx] + maxConfsLPSum[idx-1] >= Lcutoff)
+                break;
+            counter[idx] = 0;
+            idx++;
+        }
+
+        for(int ii=idx-1; ii>0; ii--)
+            partialLProbs[ii] = partialLProbs[ii+1] + marginalResults[ii]->get_lProb(0);
+    }
 }
 
 /*
@@ -415,25 +772,40 @@ void IsoThresholdGeneratorMT::terminate_search()
 
 IsoThresholdGenerator::IsoThresholdGenerator(Iso&& iso, double _threshold, bool _absolute, int tabSize, int hashSize)
 : IsoGenerator(std::move(iso)),
-Lcutoff(_threshold <= 0.0 ? std::numeric_limits<double>::lowest() : (_absolute ? log(_threshold) : log(_threshold) + modeLProb))
+counter(nullptr),
+maxConfsLPSum(nullptr),
+Lcutoff(_threshold <= 0.0 ? std::numeric_limits<double>::lowest() : (_absolute ? log(_threshold) : log(_threshold) + modeLProb)),
+marginalResults(nullptr)
 {
-    counter = new int[dimNumber];
-    maxConfsLPSum = new double[dimNumber-1];
-    marginalResults = new PrecalculatedMarginal*[dimNumber];
+    empty = false;
 
-    bool empty = false;
-
-    for(int ii=0; ii<dimNumber; ii++)
+    // Everything is allocated here: if that fails (e.g. over a MemoryBudget),
+    // what was built so far is freed before passing the exception on
+    try
     {
-        counter[ii] = 0;
-        marginalResults[ii] = new PrecalculatedMarginal(std::move(*(marginals[ii])),
-                                                        Lcutoff - modeLProb + marginals[ii]->getModeLProb(),
-                                                        true,
-                                                        tabSize,
-                                                        hashSize);
+        counter = resource_new<int>(generator_resource, dimNumber);
+        maxConfsLPSum = resource_new<double>(generator_resource, dimNumber);
+        marginalResults = resource_new<PrecalculatedMarginal*>(generator_resource, dimNumber);
+        for(int ii=0; ii<dimNumber; ii++)
+            marginalResults[ii] = nullptr;
 
-        if(not marginalResults[ii]->inRange(0))
-            empty = true;
+        for(int ii=0; ii<dimNumber; ii++)
+        {
+            counter[ii] = 0;
+            marginalResults[ii] = resource_construct<PrecalculatedMarginal>(generator_resource, std::move(*(marginals[ii])),
+                                                            Lcutoff - modeLProb + marginals[ii]->getModeLProb(),
+                                                            true,
+                                                            tabSize,
+                                                            hashSize);
+
+            if(not marginalResults[ii]->inRange(0))
+                empty = true;
+        }
+    }
+    catch(...)
+    {
+        release();
+        throw;
     }
 
     maxConfsLPSum[0] = marginalResults[0]->getModeLProb();
@@ -451,6 +823,19 @@ Lcutoff(_threshold <= 0.0 ? std::numeric_limits<double>::lowest() : (_absolute ?
 
 }
 
+IsoThresholdGenerator::~IsoThresholdGenerator()
+{
+    release();
+}
+
+void IsoThresholdGenerator::release()
+{
+    resource_delete(generator_resource, counter, dimNumber);
+    resource_delete(generator_resource, maxConfsLPSum, dimNumber);
+    if(marginalResults != nullptr)
+        dealloc_table(generator_resource, marginalResults, dimNumber);
+}
+
 bool IsoThresholdGenerator::advanceToNextConfiguration()
 {
     counter[0]++;
@@ -487,8 +872,70 @@ bool IsoThresholdGenerator::advanceToNextConfiguration()
 
 void IsoThresholdGenerator::terminate_search()
 {
+    // Park the counters on the last entries and poison the partial sums, so that
+    // any further advance just runs into the guardians and fails.
     for(int ii=0; ii<dimNumber; ii++)
-        counter[ii] = marginalResults[ii]->get_no_confs();
+    {
+        counter[ii] = marginalResults[ii]->get_no_confs()-1;
+        partialLProbs[ii] = -std::numeric_limits<double>::infinity();
+    }
+    partialLProbs[dimNumber] = -std::numeric_limits<double>::infinity();
+}
+
+void IsoThresholdGenerator::reset()
+{
+    if(empty)
+    {
+        terminate_search();
+        return;
+    }
+
+    partialLProbs[dimNumber] = 0.0;
+    memset(counter, 0, dimNumber * sizeof(int));
+    recalc(dimNumber-1);
+    counter[0]--;
+}
+
+size_t IsoThresholdGenerator::count_confs() const
+{
+    // terminate_search poisons the partial sums of an exhausted generator
+    if(empty or partialLProbs[dimNumber] == -std::numeric_limits<double>::infinity())
+        return 0;
+
+    // Same walk as in advanceToNextConfiguration, from where the generator is,
+    // except that the first marginal is dealt with in one go for each setting of
+    // the higher counters, and neither masses nor probabilities are calculated.
+    // It goes over copies of the counters and partial sums.
+    std::vector<int> cntr(counter, counter + dimNumber);
+    std::vector<double> lprobs(partialLProbs, partialLProbs + dimNumber + 1);
+    const double* lProbs0 = marginalResults[0]->get_lProbs_ptr();
+    const unsigned int no_confs0 = marginalResults[0]->get_no_confs();
+
+    // What is left of the first marginal for the current higher counters
+    size_t count = count_above_cutoff(lProbs0, no_confs0, lprobs[1], Lcutoff);
+    const size_t done = cntr[0] + 1;
+    count = count > done ? count - done : 0;
+
+    while(true)
+    {
+        int idx = 1;
+        while(true)
+        {
+            if(idx >= dimNumber)
+                return count;
+            cntr[idx]++;
+            lprobs[idx] = lprobs[idx+1] + marginalResults[idx]->get_lProb(cntr[idx]);
+            if(lprobs[idx] + maxConfsLPSum[idx-1] >= Lcutoff)
+                break;
+            cntr[idx] = 0;
+            idx++;
+        }
+
+        for(int ii=idx-1; ii>0; ii--)
+            lprobs[ii] = lprobs[ii+1] + marginalResults[ii]->get_lProb(0);
+
+        count += count_above_cutoff(lProbs0, no_confs0, lprobs[1], Lcutoff);
+    }
 }
 
 /*
@@ -496,66 +943,106 @@ void IsoThresholdGenerator::terminate_search()
  */
 
 IsoOrderedGenerator::IsoOrderedGenerator(Iso&& iso, int _tabSize, int _hashSize) :
-IsoGenerator(std::move(iso)), allocator(dimNumber, _tabSize)
+IsoGenerator(std::move(iso)), marginalResults(nullptr),
+pq(ConfOrder(), resource_vector<void*>(resource->component(MEMORY_QUEUES))),
+allocator(dimNumber, _tabSize, resource->component(MEMORY_CONF_PAGES)),
+logProbs(nullptr), masses(nullptr), marginalConfs(nullptr), candidate(nullptr)
 {
-    delete[] partialLProbs;
-    delete[] partialMasses;
-    delete[] partialExpProbs;
+    resource_delete(generator_resource, partialLProbs, dimNumber+1+PADDING);
+    resource_delete(generator_resource, partialMasses, dimNumber+1+PADDING);
+    resource_delete(generator_resource, partialExpProbs, dimNumber+1+PADDING);
 
     partialLProbs = &currentLProb;
     partialMasses = &currentMass;
     partialExpProbs = &currentEProb;
 
-    marginalResults = new MarginalTrek*[dimNumber];
-
-    for(int i = 0; i<dimNumber; i++)
-        marginalResults[i] = new MarginalTrek(std::move(*(marginals[i])), _tabSize, _hashSize);
-
-    logProbs        = new const vector<double>*[dimNumber];
-    masses          = new const vector<double>*[dimNumber];
-    marginalConfs   = new const vector<int*>*[dimNumber];
-    candidate	    = new int[dimNumber];
-
-    for(int i = 0; i<dimNumber; i++)
+    // As in IsoThresholdGenerator: nothing is leaked if the resource throws
+    try
     {
-        masses[i] = &marginalResults[i]->conf_masses();
-        logProbs[i] = &marginalResults[i]->conf_probs();
-        marginalConfs[i] = &marginalResults[i]->confs();
-    }
+        marginalResults = resource_new<MarginalTrek*>(generator_resource, dimNumber);
+        for(int i = 0; i<dimNumber; i++)
+            marginalResults[i] = nullptr;
 
-    topConf = allocator.newConf();
-    memset(
-            reinterpret_cast<char*>(topConf) + sizeof(double),
-            0,
-            sizeof(int)*dimNumber
-    );
+        for(int i = 0; i<dimNumber; i++)
+            marginalResults[i] = resource_construct<MarginalTrek>(generator_resource, std::move(*(marginals[i])), _tabSize, _hashSize);
 
-    *(reinterpret_cast<double*>(topConf)) =
-    combinedSum(
-                getConf(topConf),
-                logProbs,
-                dimNumber
-    );
+        logProbs        = resource_new<const resource_vector<double>*>(generator_resource, dimNumber);
+        masses          = resource_new<const resource_vector<double>*>(generator_resource, dimNumber);
+        marginalConfs   = resource_new<const resource_vector<int*>*>(generator_resource, dimNumber);
+        candidate	    = resource_new<int>(generator_resource, dimNumber);
 
-    pq.push(topConf);
+        for(int i = 0; i<dimNumber; i++)
+        {
+            masses[i] = &marginalResults[i]->conf_masses();
+            logProbs[i] = &marginalResults[i]->conf_probs();
+            marginalConfs[i] = &marginalResults[i]->confs();
+        }
 
+        topConf = allocator.newConf();
+        memset(
+                reinterpret_cast<char*>(topConf) + sizeof(double),
+                0,
+                sizeof(int)*dimNumber
+        );
+
+        *(reinterpret_cast<double*>(topConf)) =
+        combinedSum(
+                    getConf(topConf),
+                    logProbs,
+                    dimNumber
+        );
+
+        pq.push(topConf);
+    }
+    catch(...)
+    {
+        release();
+        throw;
+    }
 }
 
 
 IsoOrderedGenerator::~IsoOrderedGenerator()
 {
-    dealloc_table<MarginalTrek*>(marginalResults, dimNumber);
-    delete[] logProbs;
-    delete[] masses;
-    delete[] marginalConfs;
-    delete[] candidate;
+    release();
+}
+
+void IsoOrderedGenerator::release()
+{
+    if(marginalResults != nullptr)
+        dealloc_table(generator_resource, marginalResults, dimNumber);
+    resource_delete(generator_resource, logProbs, dimNumber);
+    resource_delete(generator_resource, masses, dimNumber);
+    resource_delete(generator_resource, marginalConfs, dimNumber);
+    resource_delete(generator_resource, candidate, dimNumber);
     partialLProbs = nullptr;
     partialMasses = nullptr;
     partialExpProbs = nullptr;
 }
 
+void IsoOrderedGenerator::terminate_search()
+{
+    while(not pq.empty())
+        pq.pop();
+}
+
 
 bool IsoOrderedGenerator::advanceToNextConfiguration()
+{
+    // Both the marginals and the queue grow as configurations are visited:
+    // running out of the memory budget ends the enumeration
+    try
+    {
+        return advance();
+    }
+    catch(MemoryBudgetExceeded&)
+    {
+        terminate_search();
+        return false;
+    }
+}
+
+inline bool IsoOrderedGenerator::advance()
 {
     if(pq.size() < 1)
         return false;
@@ -615,155 +1102,151 @@ bool IsoOrderedGenerator::advanceToNextConfiguration()
 
 IsoLayeredGenerator::IsoLayeredGenerator(Iso&& iso, double _delta, int tabSize, int hashSize)
 : IsoGenerator(std::move(iso)),
-current_layer_lcutoff(nextafter(modeLProb, std::numeric_limits<double>::infinity())),
-delta(_delta)
+counter(nullptr),
+maxConfsLPSum(nullptr),
+last_layer_lcutoff(std::numeric_limits<double>::infinity()),
+current_layer_lcutoff(modeLProb + _delta),
+marginalResults(nullptr),
+delta(_delta),
+final_cutoff(0.0)
 {
-
-    counter = new int[dimNumber];
-    maxConfsLPSum = new double[dimNumber-1];
-
-    marginalResults = new LayeredMarginal*[dimNumber];
-
-    final_cutoff = -100000.0; // FIXME
-
-    for(int ii=0; ii<dimNumber; ii++)
+    // As in IsoThresholdGenerator: nothing is leaked if the resource throws
+    try
     {
-        counter[ii] = 0;
+        counter = resource_new<int>(generator_resource, dimNumber);
+        maxConfsLPSum = resource_new<double>(generator_resource, dimNumber);
 
-        marginalResults[ii] = new LayeredMarginal(std::move(*(marginals[ii])),
-                                                            tabSize,
-                                                            hashSize);
+        marginalResults = resource_new<LayeredMarginal*>(generator_resource, dimNumber);
+        for(int ii=0; ii<dimNumber; ii++)
+            marginalResults[ii] = nullptr;
 
-        final_cutoff += marginalResults[ii]->getSmallestLProb();
-    }
+        for(int ii=0; ii<dimNumber; ii++)
+        {
+            marginalResults[ii] = resource_construct<LayeredMarginal>(generator_resource, std::move(*(marginals[ii])),
+                                                                tabSize,
+                                                                hashSize);
 
-    maxConfsLPSum[0] = marginalResults[0]->getModeLProb();
-    for(int ii=1; ii<dimNumber-1; ii++)
-        maxConfsLPSum[ii] = maxConfsLPSum[ii-1] + marginalResults[ii]->getModeLProb();
+            // No configuration can be less probable than this
+            final_cutoff += marginalResults[ii]->getSmallestLProb();
+        }
 
+        maxConfsLPSum[0] = marginalResults[0]->getModeLProb();
+        for(int ii=1; ii<dimNumber-1; ii++)
+            maxConfsLPSum[ii] = maxConfsLPSum[ii-1] + marginalResults[ii]->getModeLProb();
 
-    
-    for(int ii=dimNumber-1; ii>0; ii--)
+        setupLayer();
+    }
+    catch(...)
     {
-    	partialLProbs[ii] = partialLProbs[ii+1] + marginalResults[ii]->getModeLProb();
-	partialMasses[ii] = partialMasses[ii+1] + marginalResults[ii]->getModeMass();
-	partialExpProbs[ii] = partialExpProbs[ii+1] + marginalResults[ii]->getModeEProb();
+        release();
+        throw;
     }
-
-    last_counters = new int[dimNumber-1];
-    nextLayer(_delta);
 }
 
 
 bool IsoLayeredGenerator::nextLayer(double logCutoff_delta)
 {
+    if(current_layer_lcutoff <= final_cutoff)
+        return false; // Everything was already enumerated
+
     last_layer_lcutoff = current_layer_lcutoff;
     current_layer_lcutoff += logCutoff_delta;
 
-    std::cout << "=============================================================================================\nNextLayer\n=============================================================================================\n\n\n";
+    // Marginals are extended layer by layer: running out of the memory
+    // budget ends the enumeration
+    try
+    {
+        setupLayer();
+    }
+    catch(MemoryBudgetExceeded&)
+    {
+        terminate_search();
+        return false;
+    }
 
-    std::cout << "nextLayer LLC: " << last_layer_lcutoff << " CCC: " << current_layer_lcutoff << std::endl;
+    return true;
+}
 
-    if(last_layer_lcutoff<final_cutoff)
-        return false;
 
+void IsoLayeredGenerator::setupLayer()
+{
     for(int ii=0; ii<dimNumber; ii++)
-    {
-        std::cout << "Extending marginal " << ii << std::endl;
-        marginalResults[ii]->extend(current_layer_lcutoff - modeLProb + marginals[ii]->getModeLProb());
-        std::cout << "Done extending marginal" << std::endl;
-    }
+        marginalResults[ii]->extend(current_layer_lcutoff - modeLProb + marginalResults[ii]->getModeLProb());
 
-	memset(counter, 0, dimNumber * sizeof(unsigned int));
+    memset(counter, 0, dimNumber * sizeof(int));
 
     recalc(dimNumber-1);
 
-    counter[0] = marginalResults[0]->get_no_confs();
+    skipPreviousLayers();
 
-    for(int ii=0; ii<dimNumber-1; ii++)
-        last_counters[ii] = counter[0];
-
-    return true;
+    counter[0]--;
 }
 
 
-bool IsoLayeredGenerator::advanceToNextConfiguration_internal()
+bool IsoLayeredGenerator::advanceToNextConfigurationWithinLayer()
 {
-    std::cout << "cntr: " << counter[0] << " " << counter[1] << std::endl;
-    counter[0]--;
-    double cprob = partialLProbs[1] + marginalResults[0]->get_lProb(counter[0]);
-
-    if(cprob <= last_layer_lcutoff)
+    counter[0]++;
+    partialLProbs[0] = partialLProbs[1] + marginalResults[0]->get_lProb(counter[0]);
+    if(partialLProbs[0] >= current_layer_lcutoff)
     {
-        partialLProbs[0] = cprob;
         partialMasses[0] = partialMasses[1] + marginalResults[0]->get_mass(counter[0]);
         partialExpProbs[0] = partialExpProbs[1] * marginalResults[0]->get_eProb(counter[0]);
-        std::cout << "carry not needed" << std::endl;
         return true;
     }
 
     // If we reached this point, a carry is needed
-    std::cout << "CARRY, cntr:" << counter[0] << " " << counter[1] << std::endl;
 
     int idx = 0;
-    while(idx < dimNumber-1)
+
+    while(idx<dimNumber-1)
     {
-        std::cout << "carry loop" << std::endl;
-	std::cout << "last_counters: ";
-	printArray(last_counters, 1);
         counter[idx] = 0;
-	counter[0] = last_counters[idx];
         idx++;
         counter[idx]++;
-        std::cout << "carry loop, cntr after carry: " << counter[0] << " " << counter[1] << std::endl;
         partialLProbs[idx] = partialLProbs[idx+1] + marginalResults[idx]->get_lProb(counter[idx]);
-        std::cout << "maxConfsLPSum[idx-1]: " << maxConfsLPSum[idx-1] << std::endl;
-        std::cout << "partialLProbs[idx]: " << partialLProbs[idx] << std::endl;
         if(partialLProbs[idx] + maxConfsLPSum[idx-1] >= current_layer_lcutoff)
         {
-            counter[0] = last_counters[idx];
-
-            for(int ii=idx-1; ii >=0; ii--)
-            {
-                std::cout << "PLP[i] = PLP[i+1] + MR[i]->LP[c[i]]: " << partialLProbs[ii+1] << " " << marginalResults[ii]->get_lProb(counter[ii]) << std::endl;
-                std::cout << "i: " << ii << std::endl;
-                std::cout << "cntr: " << counter[0] << " " << counter[1] << std::endl;
-                partialLProbs[ii] = partialLProbs[ii+1] + marginalResults[ii]->get_lProb(counter[ii]);
-            }
-            std::cout << "Prob: " << partialLProbs[0] << std::endl;
-            while(partialLProbs[0] < current_layer_lcutoff)
-            {
-                counter[0]--;
-                partialLProbs[0] = partialLProbs[1] + marginalResults[0]->get_lProb(counter[0]);
-                std::cout << "Prob. too low, decreasing to: " << counter[0] << " " << counter[1] << " prob: " << partialLProbs[0] << std::endl;
-            }
-
-            last_counters[idx] = counter[0];
-
-            for(int ii=0; ii<idx; ii++)
-                last_counters[ii] = last_counters[idx];
-
-            if(partialLProbs[0] <= last_layer_lcutoff)
-                return true;
-
             partialMasses[idx] = partialMasses[idx+1] + marginalResults[idx]->get_mass(counter[idx]);
             partialExpProbs[idx] = partialExpProbs[idx+1] * marginalResults[idx]->get_eProb(counter[idx]);
             recalc(idx-1);
-            std::cout << "XXX" << std::endl;
-//            return true;
 
+            skipPreviousLayers();
+
+            partialLProbs[0] = partialLProbs[1] + marginalResults[0]->get_lProb(counter[0]);
+            if(partialLProbs[0] >= current_layer_lcutoff)
+            {
+                partialMasses[0] = partialMasses[1] + marginalResults[0]->get_mass(counter[0]);
+                partialExpProbs[0] = partialExpProbs[1] * marginalResults[0]->get_eProb(counter[0]);
+                return true;
+            }
+
+            // Nothing new in this row, carry on from the lowest position
+            idx = 0;
         }
     }
 
     return false; // layer switch is needed
 }
 
+void IsoLayeredGenerator::terminate_search()
+{
+    final_cutoff = std::numeric_limits<double>::infinity();
+    current_layer_lcutoff = std::numeric_limits<double>::infinity();
+    memset(counter, 0, dimNumber * sizeof(int));
+    counter[0]--;
+}
+
 IsoLayeredGenerator::~IsoLayeredGenerator()
 {
-    dealloc_table(marginalResults, dimNumber);
-    delete[] counter;
-    delete[] maxConfsLPSum;
-    delete[] last_counters;
+    release();
+}
+
+void IsoLayeredGenerator::release()
+{
+    if(marginalResults != nullptr)
+        dealloc_table(generator_resource, marginalResults, dimNumber);
+    resource_delete(generator_resource, counter, dimNumber);
+    resource_delete(generator_resource, maxConfsLPSum, dimNumber);
 }
 
 
@@ -27,6 +27,7 @@
 #include "summator.h"
 #include "operators.h"
 #include "marginalTrek++.h"
+#include "misc.h"
 
 
 #ifdef BUILDING_R
@@ -36,16 +37,21 @@ using namespace Rcpp;
 
 
 
-unsigned int parse_formula(const char* formula, std::vector<const double*>& isotope_masses, std::vector<const double*>& isotope_probabilities, int** isotopeNumbers, int** atomCounts, unsigned int* confSize);
+unsigned int parse_formula(const char* formula, std::vector<const double*>& isotope_masses, std::vector<const double*>& isotope_probabilities, int** isotopeNumbers, int** atomCounts, unsigned int* confSize, MemoryResource* resource = default_memory_resource());
 
 class IsoThresholdGenerator;
 
 class Iso {
 private:
     void setupMarginals(const double* const * _isotopeMasses, const double* const * _isotopeProbabilities);
+    void setupRows(const int* _isotopeNumbers, const int* _atomCounts,
+                   const double* const * _isotopeMasses, const double* const * _isotopeProbabilities);
+    void release();
 public:
     bool disowned;
 protected:
+    MemoryAccounting*   accounting;     // of everything below, and of the generator's state
+    MemoryResource*     resource;       // that accounting, which takes it from the given resource
     int 		dimNumber;
     int*		isotopeNumbers;
     int*		atomCounts;
@@ -53,17 +59,86 @@ protected:
     int			allDim;
     Marginal**          marginals;
     double              modeLProb;
+    int                 rowsNumber;     // elements as given to the constructor
+    int*                rowMarginals;   // nullptr unless some of them were merged
+    int*                rowAtomCounts;  // likewise, the atom counts of the rows
+
+    // Writes the configurations of the marginals (conf(ii) for the ii-th one) in the
+    // layout of the rows the Iso was constructed from. The atoms of a marginal made
+    // of several rows are split back among them greedily: each row in turn takes as
+    // many atoms as it was given, starting from the isotopes the earlier rows left,
+    // in the order of the isotopes. So each row keeps its own atom count.
+    template<typename ConfOf> inline void layout_conf(int* space, const ConfOf& conf) const
+    {
+        if(rowMarginals == nullptr)
+            for(int ii=0; ii<dimNumber; ii++)
+            {
+                memcpy(space, conf(ii), isotopeNumbers[ii]*sizeof(int));
+                space += isotopeNumbers[ii];
+            }
+        else
+            for(int ii=0; ii<dimNumber; ii++)
+            {
+                const int* marginal_conf = conf(ii);
+                int isotope = 0;    // the first isotope not yet used up by earlier rows
+                int used = 0;       // and how many of its atoms they took
+                int* row_space = space;
+                for(int row=0; row<rowsNumber; row++)
+                {
+                    const int isoNo = isotopeNumbers[rowMarginals[row]];
+                    if(rowMarginals[row] == ii)
+                    {
+                        int left = rowAtomCounts[row];
+                        for(int jj=0; jj<isoNo; jj++)
+                        {
+                            int taken = 0;
+                            if(jj == isotope)
+                            {
+                                taken = std::min(marginal_conf[jj] - used, left);
+                                left -= taken;
+                                used += taken;
+                                if(used == marginal_conf[jj] and isotope+1 < isoNo)
+                                {
+                                    isotope++;
+                                    used = 0;
+                                }
+                            }
+                            row_space[jj] = taken;
+                        }
+                    }
+                    row_space += isoNo;
+                }
+            }
+    }
 
 public:
+    // Rows with identical isotope tables (the same element given more than once)
+    // are merged into one marginal, with the atom counts summed up (see layout_conf
+    // for how its configurations are split back among the rows).
+    // All the memory of the Iso, and of the generator it is moved into, comes from
+    // resource (if null, operator new, or huge_page_resource() with huge pages
+    // on), which has to outlive them. Shallow copies
+    // (Iso(other, false), as used by worker threads) allocate with operator new.
     Iso(
         int             _dimNumber,
         const int*      _isotopeNumbers,
         const int*      _atomCounts,
         const double* const *  _isotopeMasses,
-        const double* const *  _isotopeProbabilities
+        const double* const *  _isotopeProbabilities,
+        MemoryResource* _resource = nullptr
+    );
+
+    // Elements given by atomic number, with the natural isotope abundances from the
+    // element tables (no need to look up the log-probabilities). Throws
+    // std::invalid_argument for unknown atomic numbers.
+    Iso(
+        int             _dimNumber,
+        const int*      _atomicNumbers,
+        const int*      _atomCounts,
+        MemoryResource* _resource = nullptr
     );
 
-    Iso(const char* formula);
+    Iso(const char* formula, MemoryResource* _resource = nullptr);
     Iso(Iso&& other);
     Iso(const Iso& other, bool fullcopy);
 
@@ -75,7 +150,17 @@ public:
     inline int getDimNumber() const { return dimNumber; };
     inline int getAllDim() const { return allDim; };
 
+    // Bytes currently taken by a component of the Iso and its generator (all of
+    // them for MEMORY_TOTAL), and the most they have taken so far. Zero for
+    // shallow copies, which don't keep accounts.
+    inline size_t memory_used(MemoryComponent c = MEMORY_TOTAL) const { return accounting == nullptr ? 0 : accounting->used(c); };
+    inline size_t memory_peak(MemoryComponent c = MEMORY_TOTAL) const { return accounting == nullptr ? 0 : accounting->peak(c); };
+
+    // Marginals shared by the threads of IsoThresholdGeneratorMT, made out of (and
+    // using up) those of the Iso, with the last one a SyncMarginal. They come from
+    // the resource of the Iso, and go back to it with free_MT_marginal_set.
     PrecalculatedMarginal** get_MT_marginal_set(double Lcutoff, bool absolute, int tabSize, int hashSize);
+    void free_MT_marginal_set(PrecalculatedMarginal** PMs);
 
 
 };
@@ -86,6 +171,7 @@ public:
 class IsoGenerator : public Iso
 {
 protected:
+    MemoryResource* const generator_resource;  // of the generator's own state
     double* partialLProbs;
     double* partialMasses;
     double* partialExpProbs;
@@ -97,6 +183,12 @@ public:
     inline double eprob() const { return partialExpProbs[0]; };
     virtual void get_conf_signature(int* space) const = 0;
 
+    // Compact form of the current configuration: its index in each of the
+    // marginals (dimNumber ints instead of allDim). expand_conf turns it into
+    // the full signature, for as long as the generator is alive.
+    virtual void get_marginal_indices(int* space) const = 0;
+    virtual void expand_conf(const int* indices, int* space) const = 0;
+
     IsoGenerator(Iso&& iso);
     virtual ~IsoGenerator();
 };
@@ -106,12 +198,12 @@ class IsoOrderedGenerator: public IsoGenerator
 {
 private:
     MarginalTrek** marginalResults;
-    std::priority_queue<void*,std::vector<void*>,ConfOrder> pq;
+    std::priority_queue<void*,resource_vector<void*>,ConfOrder> pq;
     void* topConf;
     DirtyAllocator allocator;
-    const std::vector<double>**     logProbs;
-    const std::vector<double>**     masses;
-    const std::vector<int*>**       marginalConfs;
+    const resource_vector<double>** logProbs;
+    const resource_vector<double>** masses;
+    const resource_vector<int*>**   marginalConfs;
     double currentLProb;
     double currentMass;
     double currentEProb;
@@ -127,20 +219,33 @@ public:
         if (ccount >= 0)
             c[ccount]--;
 
-        for(int ii=0; ii<dimNumber; ii++)
-        {
-            memcpy(space, marginalResults[ii]->confs()[c[ii]], isotopeNumbers[ii]*sizeof(int));
-            space += isotopeNumbers[ii];
-        }
+        layout_conf(space, [&](int ii) { return marginalResults[ii]->confs()[c[ii]]; });
 
         if (ccount >= 0)
             c[ccount]++;
     };
+    inline void get_marginal_indices(int* space) const override final
+    {
+        memcpy(space, getConf(topConf), dimNumber*sizeof(int));
+
+        if (ccount >= 0)
+            space[ccount]--;
+    };
+    inline void expand_conf(const int* indices, int* space) const override final
+    {
+        layout_conf(space, [&](int ii) { return marginalResults[ii]->confs()[indices[ii]]; });
+    };
 
     IsoOrderedGenerator(Iso&& iso, int _tabSize  = 1000, int _hashSize = 1000);
 
     virtual ~IsoOrderedGenerator();
 
+    void terminate_search();
+
+private:
+    bool advance();
+    void release();
+
 };
 
 class IsoThresholdGenerator: public IsoGenerator
@@ -150,28 +255,40 @@ private:
     double* maxConfsLPSum;
     const double Lcutoff;
     PrecalculatedMarginal** marginalResults;
+    bool empty;
 
 public:
     bool advanceToNextConfiguration() override final;
     inline void get_conf_signature(int* space) const override final
     {
-        for(int ii=0; ii<dimNumber; ii++)
-        {
-            memcpy(space, marginalResults[ii]->get_conf(counter[ii]), isotopeNumbers[ii]*sizeof(int));
-            space += isotopeNumbers[ii];
-        }
+        layout_conf(space, [&](int ii) { return marginalResults[ii]->get_conf(counter[ii]); });
+    };
+    inline void get_marginal_indices(int* space) const override final
+    {
+        memcpy(space, counter, dimNumber*sizeof(int));
+    };
+    inline void expand_conf(const int* indices, int* space) const override final
+    {
+        layout_conf(space, [&](int ii) { return marginalResults[ii]->get_conf(indices[ii]); });
     };
 
     IsoThresholdGenerator(Iso&& iso, double _threshold, bool _absolute=true,
                         int _tabSize=1000, int _hashSize=1000);
 
-    inline virtual ~IsoThresholdGenerator() { delete[] counter;
-                                            delete[] maxConfsLPSum;
-                                            dealloc_table(marginalResults, dimNumber); };
+    virtual ~IsoThresholdGenerator();
 
     void terminate_search();
 
+    // Rewinds the generator to the state right after construction
+    void reset();
+
+    // Counts the configurations the generator has yet to produce, much faster
+    // than going through them. The generator itself is left as it was.
+    size_t count_confs() const;
+
 private:
+    void release();
+
     inline void recalc(int idx)
     {
         for(; idx >=0; idx--)
@@ -200,19 +317,32 @@ private:
 public:
     bool advanceToNextConfiguration() override final;
     inline void get_conf_signature(int* space) const override final
+    {
+        layout_conf(space, [&](int ii) { return marginalResults[ii]->get_conf(counter[ii]); });
+    };
+    inline void get_marginal_indices(int* space) const override final
     {
         for(int ii=0; ii<dimNumber; ii++)
-        {
-            memcpy(space, marginalResults[ii]->get_conf(counter[ii]), isotopeNumbers[ii]*sizeof(int));
-            space += isotopeNumbers[ii];
-        }
+            space[ii] = counter[ii];
+    };
+    inline void expand_conf(const int* indices, int* space) const override final
+    {
+        layout_conf(space, [&](int ii) { return marginalResults[ii]->get_conf(indices[ii]); });
     };
 
     IsoThresholdGeneratorMT(Iso&& iso, double  _threshold, PrecalculatedMarginal** marginals, bool _absolute = true);
 
-    inline virtual ~IsoThresholdGeneratorMT() { delete[] counter; delete[] maxConfsLPSum;};
+    virtual ~IsoThresholdGeneratorMT();
     void terminate_search();
 
+    // Configurations are handed out to threads in slices: all those sharing
+    // the index of the last (shared) marginal.
+    inline unsigned int get_slice() const { return counter[dimNumber-1]; };
+
+    // Counts the configurations in a given slice, without calculating them.
+    // Leaves the generator terminated.
+    size_t count_slice(unsigned int slice);
+
 private:
     inline void recalc(int idx)
     {
@@ -236,35 +366,35 @@ private:
     int* counter;
     double* maxConfsLPSum;
     double last_layer_lcutoff, current_layer_lcutoff;
-    Summator current_sum;
     LayeredMarginal** marginalResults;
-    double* probsExcept;
-    int* last_counters;
     double delta;
     double final_cutoff;
 
 public:
-    bool advanceToNextConfiguration_internal();
-    inline void setup_delta(double new_delta) { delta = new_delta; nextLayer(delta); };
+    bool advanceToNextConfigurationWithinLayer();
     inline bool advanceToNextConfiguration() override final
     {
-        while (not advanceToNextConfiguration_internal())
+        while (not advanceToNextConfigurationWithinLayer())
             if (not nextLayer(delta))
                 return false;
-        std::cout << "Returning conf: " << counter[0] << " " << counter[1] << " " << partialLProbs[0] << std::endl;
         return true;
     }
     bool nextLayer(double logCutoff_delta); // Arg should be negative
+    inline double get_delta() const { return delta; };
 
     IsoLayeredGenerator(Iso&& iso, double _delta = -3.0, int _tabSize  = 1000, int _hashSize = 1000);
 
     inline void get_conf_signature(int* space) const override final
     {
-        for(int ii=0; ii<dimNumber; ii++)
-        {
-            memcpy(space, marginalResults[ii]->get_conf(counter[ii]), isotopeNumbers[ii]*sizeof(int));
-            space += isotopeNumbers[ii];
-        }
+        layout_conf(space, [&](int ii) { return marginalResults[ii]->get_conf(counter[ii]); });
+    };
+    inline void get_marginal_indices(int* space) const override final
+    {
+        memcpy(space, counter, dimNumber*sizeof(int));
+    };
+    inline void expand_conf(const int* indices, int* space) const override final
+    {
+        layout_conf(space, [&](int ii) { return marginalResults[ii]->get_conf(indices[ii]); });
     };
 
     virtual ~IsoLayeredGenerator();
@@ -272,6 +402,9 @@ public:
     void terminate_search();
 
 private:
+    void setupLayer();
+    void release();
+
     inline void recalc(int idx)
     {
         for(; idx >=0; idx--)
@@ -281,6 +414,15 @@ private:
             partialExpProbs[idx] = partialExpProbs[idx+1] * marginalResults[idx]->get_eProb(counter[idx]);
         }
     }
+
+    // Moves counter[0] past the configurations (with the current values of
+    // higher counters) that were already returned in previous layers.
+    inline void skipPreviousLayers()
+    {
+        // At most the marginal's get_no_confs(), which fits
+        counter[0] = static_cast<int>(count_above_cutoff(marginalResults[0]->get_lProbs_ptr(), marginalResults[0]->get_no_confs(),
+                                                         partialLProbs[1], last_layer_lcutoff));
+    }
 };
 
 
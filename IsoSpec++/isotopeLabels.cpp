@@ -0,0 +1,248 @@
+/*
+ *   Copyright (C) 2015-2016 Mateusz Łącki and Michał Startek.
+ *
+ *   This file is part of IsoSpec.
+ *
+ *   IsoSpec is free software: you can redistribute it and/or modify
+ *   it under the terms of the Simplified ("2-clause") BSD licence.
+ *
+ *   IsoSpec is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *   You should have received a copy of the Simplified BSD Licence
+ *   along with IsoSpec.  If not, see <https://opensource.org/licenses/BSD-2-Clause>.
+ */
+
+
+#include <string.h>
+#include <stdlib.h>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+#include <mutex>
+#include "isotopeLabels.h"
+#include "element_tables.h"
+
+
+// Element symbols are a capital letter, optionally followed by a lowercase one,
+// so they map directly onto 26*27 slots: no hashing of strings needed.
+#define SYMBOL_SLOTS (26*27)
+#define ATOMIC_NO_SLOTS 128
+
+class ElementIndex
+{
+public:
+    short first_isotope[SYMBOL_SLOTS];   // -1 where there is no such element
+    short isotope_no[SYMBOL_SLOTS];
+    short first_by_atomic_no[ATOMIC_NO_SLOTS];
+    short isotope_no_by_atomic_no[ATOMIC_NO_SLOTS];
+
+    ElementIndex()
+    {
+        for(int ii=0; ii<SYMBOL_SLOTS; ii++)
+        {
+            first_isotope[ii] = -1;
+            isotope_no[ii] = 0;
+        }
+        for(int ii=0; ii<ATOMIC_NO_SLOTS; ii++)
+        {
+            first_by_atomic_no[ii] = -1;
+            isotope_no_by_atomic_no[ii] = 0;
+        }
+
+        for(int ii=0; ii<NUMBER_OF_ISOTOPIC_ENTRIES; ii++)
+        {
+            const char* symbol = elem_table_symbol[ii];
+            const int slot = (symbol[0]-'A')*27 + (symbol[1] == '\0' ? 0 : symbol[1]-'a'+1);
+            if(first_isotope[slot] < 0)
+                first_isotope[slot] = ii;
+            isotope_no[slot]++;
+
+            const int atomicNo = elem_table_atomicNo[ii];
+            if(first_by_atomic_no[atomicNo] < 0)
+                first_by_atomic_no[atomicNo] = ii;
+            isotope_no_by_atomic_no[atomicNo]++;
+        }
+    }
+};
+
+static const ElementIndex& element_index()
+{
+    static const ElementIndex index;
+    return index;
+}
+
+int find_element(const char* symbol, size_t length, int* isotope_no)
+{
+    if(length == 0 or length > 2 or symbol[0] < 'A' or symbol[0] > 'Z')
+        return -1;
+    int slot = (symbol[0]-'A')*27;
+    if(length == 2)
+    {
+        if(symbol[1] < 'a' or symbol[1] > 'z')
+            return -1;
+        slot += symbol[1]-'a'+1;
+    }
+    const ElementIndex& index = element_index();
+    *isotope_no = index.isotope_no[slot];
+    return index.first_isotope[slot];
+}
+
+int find_element_by_atomic_number(int atomicNo, int* isotope_no)
+{
+    if(atomicNo < 0 or atomicNo >= ATOMIC_NO_SLOTS)
+        return -1;
+    const ElementIndex& index = element_index();
+    *isotope_no = index.isotope_no_by_atomic_no[atomicNo];
+    return index.first_by_atomic_no[atomicNo];
+}
+
+
+struct IsotopeLabel
+{
+    int first;
+    std::string name;           // registered name, or the spec itself
+    std::vector<double> probs;
+};
+
+// Never shrinks: pointers to the tables are handed out for good
+static std::deque<IsotopeLabel> labels;
+static std::mutex labels_mutex;
+
+static inline bool label_space(char c) { return c == ' ' or c == '\t' or c == '\n' or c == '\r'; }
+
+static std::vector<double> parse_label_spec(int first, int isotope_no, const char* spec, size_t length)
+{
+    const char* p = spec;
+    const char* end = spec + length;
+    std::vector<bool> given(isotope_no, false);
+    std::vector<double> probs(isotope_no, 0.0);
+    double given_sum = 0.0;
+
+    while(p < end)
+    {
+        while(p < end and label_space(*p)) p++;
+
+        int massNo = 0;
+        const char* digits = p;
+        while(p < end and *p >= '0' and *p <= '9' and massNo < 1000)
+            massNo = massNo*10 + (*p++ - '0');
+        if(p == digits)
+            throw std::invalid_argument("Invalid isotope label");
+
+        // The symbol is optional, but has to be the labelled element's
+        const char* symbol = p;
+        while(p < end and ((*p >= 'A' and *p <= 'Z') or (*p >= 'a' and *p <= 'z')))
+            p++;
+        if(p > symbol and (strlen(elem_table_symbol[first]) != static_cast<size_t>(p - symbol) or
+                           strncmp(elem_table_symbol[first], symbol, p - symbol) != 0))
+            throw std::invalid_argument("Invalid isotope label");
+
+        while(p < end and label_space(*p)) p++;
+        if(p == end or *p != '=')
+            throw std::invalid_argument("Invalid isotope label");
+        p++;
+
+        // strtod needs a terminated string
+        const char* value = p;
+        while(p < end and *p != ',')
+            p++;
+        const std::string number(value, p - value);
+        char* number_end;
+        const double abundance = strtod(number.c_str(), &number_end);
+        while(label_space(*number_end)) number_end++;
+        if(number_end == number.c_str() or *number_end != '\0' or not (abundance >= 0.0 and abundance <= 1.0))
+            throw std::invalid_argument("Invalid isotope label");
+
+        int ii = 0;
+        while(ii < isotope_no and elem_table_massNo[first+ii] != massNo)
+            ii++;
+        if(ii == isotope_no or given[ii])
+            throw std::invalid_argument("Invalid isotope label");
+        given[ii] = true;
+        probs[ii] = abundance;
+        given_sum += abundance;
+
+        if(p < end)
+            p++;    // ','
+    }
+
+    if(given_sum > 1.0 + 1e-9)
+        throw std::invalid_argument("Isotope abundances sum up to more than 1");
+
+    double natural_rest = 0.0;
+    for(int ii=0; ii<isotope_no; ii++)
+        if(not given[ii])
+            natural_rest += elem_table_probability[first+ii];
+
+    if(natural_rest > 0.0)
+    {
+        const double rest = given_sum < 1.0 ? 1.0 - given_sum : 0.0;
+        for(int ii=0; ii<isotope_no; ii++)
+            if(not given[ii])
+                probs[ii] = rest * elem_table_probability[first+ii] / natural_rest;
+    }
+    else if(std::fabs(given_sum - 1.0) > 1e-9)
+        throw std::invalid_argument("Isotope abundances do not sum up to 1");
+
+    // Fully labelled elements: log(0) would turn the log-probabilities of the
+    // configurations into NaNs, so absent isotopes get a negligible abundance
+    for(int ii=0; ii<isotope_no; ii++)
+        if(probs[ii] <= 0.0)
+            probs[ii] = std::numeric_limits<double>::min();
+
+    return probs;
+}
+
+// Must be called with labels_mutex held
+static const double* add_label(int first, std::string&& name, std::vector<double>&& probs)
+{
+    labels.push_back(IsotopeLabel{first, std::move(name), std::move(probs)});
+    return labels.back().probs.data();
+}
+
+void register_isotope_label(const char* name, const char* element, const char* spec)
+{
+    int isotope_no;
+    const int first = find_element(element, strlen(element), &isotope_no);
+    if(first < 0)
+        throw std::invalid_argument("Unknown element");
+    if(not ((name[0] >= 'A' and name[0] <= 'Z') or (name[0] >= 'a' and name[0] <= 'z')))
+        throw std::invalid_argument("Label names have to start with a letter");
+
+    std::vector<double> probs = parse_label_spec(first, isotope_no, spec, strlen(spec));
+
+    std::lock_guard<std::mutex> lock(labels_mutex);
+    add_label(first, std::string(name), std::move(probs));
+}
+
+const double* labelled_probabilities(int first, const char* label, size_t length)
+{
+    {
+        std::lock_guard<std::mutex> lock(labels_mutex);
+        // The newest registration of a name wins
+        for(size_t ii = labels.size(); ii > 0; ii--)
+            if(labels[ii-1].first == first and labels[ii-1].name.size() == length and
+               memcmp(labels[ii-1].name.data(), label, length) == 0)
+                return labels[ii-1].probs.data();
+    }
+
+    if(length == 0 or label[0] < '0' or label[0] > '9')
+        throw std::invalid_argument("Unknown isotope label");
+
+    // A spec seen for the first time: keep its table under the spec itself
+    int isotope_no;
+    find_element(elem_table_symbol[first], strlen(elem_table_symbol[first]), &isotope_no);
+    std::vector<double> probs = parse_label_spec(first, isotope_no, label, length);
+
+    std::lock_guard<std::mutex> lock(labels_mutex);
+    // Equal tables are shared, so that Iso can merge them
+    for(size_t ii = 0; ii < labels.size(); ii++)
+        if(labels[ii].first == first and labels[ii].probs == probs)
+            return labels[ii].probs.data();
+    return add_label(first, std::string(label, length), std::move(probs));
+}
@@ -0,0 +1,51 @@
+/*
+ *   Copyright (C) 2015-2016 Mateusz Łącki and Michał Startek.
+ *
+ *   This file is part of IsoSpec.
+ *
+ *   IsoSpec is free software: you can redistribute it and/or modify
+ *   it under the terms of the Simplified ("2-clause") BSD licence.
+ *
+ *   IsoSpec is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *   You should have received a copy of the Simplified BSD Licence
+ *   along with IsoSpec.  If not, see <https://opensource.org/licenses/BSD-2-Clause>.
+ */
+
+
+#ifndef ISOTOPELABELS_H
+#define ISOTOPELABELS_H
+
+#include <stddef.h>
+
+// Index of the first isotope of the element (symbol, of the given length) in the
+// element tables, or -1 if there is no such element. Isotopes of an element are
+// consecutive; their number is stored in *isotope_no.
+int find_element(const char* symbol, size_t length, int* isotope_no);
+
+// Same, for the element of the given atomic number
+int find_element_by_atomic_number(int atomicNo, int* isotope_no);
+
+/*
+ * Isotope abundances of labelled (e.g. 13C, 15N, 2H enriched) elements, overlaid
+ * on the natural ones. A label is either a name registered with
+ * register_isotope_label, or a spec of the form "13C=0.99" (several entries may
+ * be separated by commas, the symbol may be omitted: "13=0.99"). Isotopes not
+ * mentioned in a spec share what is left in their natural proportions.
+ *
+ * Tables are kept for the lifetime of the program and shared: the same label
+ * always gives the same pointer, so Iso merges rows with equal labels.
+ */
+
+// Registers (or replaces) a named label of the element, e.g. ("SILAC", "C", "13C=0.99").
+// Names start with a letter. Throws std::invalid_argument on bad input.
+void register_isotope_label(const char* name, const char* element, const char* spec);
+
+// Abundances of the isotopes of the element starting at first in the element
+// tables, under the label (of the given length, not necessarily terminated).
+// Throws std::invalid_argument for unknown names and bad specs.
+const double* labelled_probabilities(int first, const char* label, size_t length);
+
+#endif
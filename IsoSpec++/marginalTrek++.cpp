@@ -20,8 +20,6 @@
 #include <vector>
 #include <stdlib.h>
 #include <tuple>
-#include <unordered_map>
-#include <unordered_set>
 #include <queue>
 #include <utility>
 #include <iostream>
@@ -41,9 +39,9 @@
 
 
 
-Conf initialConfigure(const int atomCnt, const int isotopeNo, const double* probs, const double* lprobs)
+Conf initialConfigure(const int atomCnt, const int isotopeNo, const double* probs, const double* lprobs, MemoryResource* resource)
 {
-    Conf res = new int[isotopeNo];
+    Conf res = resource_new<int>(resource, isotopeNo);
 
     for(int i = 0; i < isotopeNo; ++i )
     {
@@ -132,11 +130,11 @@ void printMarginal( const std::tuple<double*,double*,int*,int>& results, int dim
 #endif
 
 
-double* getMLogProbs(const double* probs, int isoNo)
+double* getMLogProbs(const double* probs, int isoNo, MemoryResource* resource)
 {
     int curr_method = fegetround();
     fesetround(FE_UPWARD);
-    double* ret = new double[isoNo];
+    double* ret = resource_new<double>(resource, isoNo);
     for(int i = 0; i < isoNo; i++)
     {
         ret[i] = log(probs[i]);
@@ -155,7 +153,7 @@ double get_loggamma_nominator(int x)
 {
     int curr_method = fegetround();
     fesetround(FE_UPWARD);
-    double ret = lgamma(x+1);
+    double ret = iso_lgamma(x+1);
     fesetround(curr_method);
     return ret;
 }
@@ -165,29 +163,47 @@ Marginal::Marginal(
     const double* _masses,
     const double* _probs,
     int _isotopeNo,
-    int _atomCnt
+    int _atomCnt,
+    const double* _lProbs,
+    MemoryResource* _resource
 ) :
 disowned(false),
+resource(_resource),
 isotopeNo(_isotopeNo),
 atomCnt(_atomCnt),
-atom_masses(array_copy<double>(_masses, _isotopeNo)),
-atom_lProbs(getMLogProbs(_probs, isotopeNo)),
+atom_masses(nullptr),
+atom_lProbs(nullptr),
 loggamma_nominator(get_loggamma_nominator(_atomCnt)),
-mode_conf(initialConfigure(atomCnt, isotopeNo, _probs, atom_lProbs)),
-mode_lprob(loggamma_nominator+unnormalized_logProb(mode_conf, atom_lProbs, isotopeNo)),
-mode_mass(mass(mode_conf, atom_masses, isotopeNo)),
-mode_eprob(exp(mode_lprob)),
-smallest_lprob(atomCnt * *std::min_element(atom_lProbs, atom_lProbs+isotopeNo))
+mode_conf(nullptr)
 {
     if(G_FACT_TABLE_SIZE-1 <= atomCnt)
     {
         std::cerr << "Subisotopologue too large..." << std::endl;
         std::abort();
     }
+
+    try
+    {
+        atom_masses = resource_copy<double>(resource, _masses, _isotopeNo);
+        atom_lProbs = _lProbs != nullptr ? resource_copy<double>(resource, _lProbs, _isotopeNo) : getMLogProbs(_probs, isotopeNo, resource);
+        mode_conf = initialConfigure(atomCnt, isotopeNo, _probs, atom_lProbs, resource);
+    }
+    catch(...)
+    {
+        resource_delete(resource, atom_masses, isotopeNo);
+        resource_delete(resource, atom_lProbs, isotopeNo);
+        throw;
+    }
+
+    mode_lprob = loggamma_nominator+unnormalized_logProb(mode_conf, atom_lProbs, isotopeNo);
+    mode_mass = mass(mode_conf, atom_masses, isotopeNo);
+    mode_eprob = exp(mode_lprob);
+    smallest_lprob = atomCnt * *std::min_element(atom_lProbs, atom_lProbs+isotopeNo);
 }
 
 Marginal::Marginal(Marginal&& other) :
 disowned(other.disowned),
+resource(other.resource),
 isotopeNo(other.isotopeNo),
 atomCnt(other.atomCnt),
 atom_masses(other.atom_masses),
@@ -206,9 +222,9 @@ Marginal::~Marginal()
 {
     if(not disowned)
     {
-        delete[] atom_masses;
-        delete[] atom_lProbs;
-        delete[] mode_conf;
+        resource_delete(resource, atom_masses, isotopeNo);
+        resource_delete(resource, atom_lProbs, isotopeNo);
+        resource_delete(resource, mode_conf, isotopeNo);
     }
 }
 
@@ -232,6 +248,33 @@ double Marginal::getHeaviestConfMass() const
 }
 
 
+// Number of ways of distributing atomCnt atoms among isotopeNo isotopes,
+// C(atomCnt+isotopeNo-1, isotopeNo-1), or anything above cap if it's more than that
+static size_t marginal_confs_no(unsigned int atomCnt, unsigned int isotopeNo, size_t cap)
+{
+    size_t res = 1;
+    for(unsigned int ii = 1; ii < isotopeNo and res <= cap; ii++)
+        res = res * (atomCnt + ii) / ii;
+    return res;
+}
+
+// Tiny marginals know exactly how many configurations they may need (plus one
+// for the scratch one), so don't get a page of tabSize of them
+static int marginal_tab_size(unsigned int atomCnt, unsigned int isotopeNo, int tabSize)
+{
+    const size_t all_confs = marginal_confs_no(atomCnt, isotopeNo, TINY_MARGINAL_CONFS);
+    return all_confs <= TINY_MARGINAL_CONFS ? static_cast<int>(all_confs) + 1 : tabSize;
+}
+
+// The visited sets never hold more than all the configurations of the marginal
+static size_t visited_slots(unsigned int atomCnt, unsigned int isotopeNo, int hashSize)
+{
+    const size_t slots = hashSize > 0 ? hashSize : 1;
+    const size_t all_confs = marginal_confs_no(atomCnt, isotopeNo, slots);
+    return std::min<size_t>(slots, all_confs + all_confs/7 + 1);
+}
+
+
 MarginalTrek::MarginalTrek(
     Marginal&& m,
     int tabSize,
@@ -239,25 +282,36 @@ MarginalTrek::MarginalTrek(
 ) :
 Marginal(std::move(m)),
 current_count(0),
-keyHasher(isotopeNo),
-equalizer(isotopeNo),
 orderMarginal(atom_lProbs, isotopeNo),
-visited(hashSize,keyHasher,equalizer),
-pq(orderMarginal),
+visited(isotopeNo, visited_slots(atomCnt, isotopeNo, hashSize), resource->component(MEMORY_HASH_TABLES)),
+pq(orderMarginal,resource_vector<Conf>(resource->component(MEMORY_QUEUES))),
 totalProb(),
-candidate(new int[isotopeNo]),
-allocator(isotopeNo, tabSize)
+candidate(nullptr),
+allocator(isotopeNo, tabSize, resource->component(MEMORY_CONF_PAGES)),
+_conf_probs(resource->component(MEMORY_MARGINALS)),
+_conf_masses(resource->component(MEMORY_MARGINALS)),
+_confs(resource->component(MEMORY_MARGINALS))
 {
-    int* initialConf = allocator.makeCopy(mode_conf);
-
-    pq.push(initialConf);
-    visited[initialConf] = 0;
+    candidate = resource_new<int>(resource->component(MEMORY_MARGINALS), isotopeNo);
 
     totalProb = Summator();
 
     current_count = 0;
 
-    add_next_conf();
+    try
+    {
+        int* initialConf = allocator.makeCopy(mode_conf);
+
+        pq.push(initialConf);
+        visited.insert(initialConf);
+
+        add_next_conf();
+    }
+    catch(...)
+    {
+        resource_delete(resource->component(MEMORY_MARGINALS), candidate, isotopeNo);
+        throw;
+    }
 }
 
 
@@ -268,7 +322,6 @@ bool MarginalTrek::add_next_conf()
     Conf topConf = pq.top();
     pq.pop();
     ++current_count;
-    visited[topConf] = current_count;
 
     _confs.push_back(topConf);
     _conf_masses.push_back(mass(topConf, atom_masses, isotopeNo));
@@ -291,12 +344,10 @@ bool MarginalTrek::add_next_conf()
                 --candidate[j];
 
                 // candidate should not have been already visited.
-                if( visited.count( candidate ) == 0 )
+                if( visited.insert( candidate ) )
                 {
                     Conf acceptedCandidate = allocator.makeCopy(candidate);
                     pq.push(acceptedCandidate);
-
-                    visited[acceptedCandidate] = 0;
                 }
             }
         }
@@ -328,7 +379,7 @@ int MarginalTrek::processUntilCutoff(double cutoff)
 
 MarginalTrek::~MarginalTrek()
 {
-    delete[] candidate;
+    resource_delete(resource->component(MEMORY_MARGINALS), candidate, isotopeNo);
 }
 
 
@@ -340,55 +391,109 @@ PrecalculatedMarginal::PrecalculatedMarginal(Marginal&& m,
         int tabSize,
         int hashSize
 ) : Marginal(std::move(m)),
-allocator(isotopeNo, tabSize)
+configurations(resource->component(MEMORY_MARGINALS)),
+allocator(isotopeNo, marginal_tab_size(atomCnt, isotopeNo, tabSize), resource->component(MEMORY_CONF_PAGES))
 {
-    const ConfEqual equalizer(isotopeNo);
-    const KeyHasher keyHasher(isotopeNo);
-    const ConfOrderMarginalDescending orderMarginal(atom_lProbs, isotopeNo);
-
-    std::unordered_set<Conf,KeyHasher,ConfEqual> visited(hashSize,keyHasher,equalizer);
+    const size_t all_confs = marginal_confs_no(atomCnt, isotopeNo, TINY_MARGINAL_CONFS);
 
     Conf currentConf = allocator.makeCopy(mode_conf);
-    if(logProb(currentConf) >= lCutOff)
+
+    if(all_confs <= TINY_MARGINAL_CONFS)
     {
-        configurations.push_back(allocator.makeCopy(currentConf));
-        visited.insert(currentConf);
-    }
+        // Go through all the configurations, as an odometer over the counts of
+        // all the isotopes but the first one, which gets the remaining atoms.
+        // Their log-probabilities are kept for sorting, instead of being
+        // recalculated in every comparison.
+        resource_vector<std::pair<double,Conf> > found(resource->component(MEMORY_MARGINALS));
+        found.reserve(all_confs);
+        memset(currentConf, 0, sizeof(int)*isotopeNo);
+        unsigned int rest = 0;
+        while(true)
+        {
+            currentConf[0] = atomCnt - rest;
+            const double lprob = logProb(currentConf);
+            if(lprob >= lCutOff)
+                found.push_back(std::make_pair(lprob, allocator.makeCopy(currentConf)));
 
-    unsigned int idx = 0;
+            unsigned int ii = 1;
+            while(ii < isotopeNo and rest == atomCnt)
+            {
+                rest -= currentConf[ii];
+                currentConf[ii] = 0;
+                ii++;
+            }
+            if(ii >= isotopeNo)
+                break;
+            currentConf[ii]++;
+            rest++;
+        }
 
-    while(idx < configurations.size())
+        if(sort)
+            std::sort(found.begin(), found.end(), [](const std::pair<double,Conf>& p1, const std::pair<double,Conf>& p2)
+                                                  { return p1.first > p2.first; });
+
+        configurations.reserve(found.size());
+        for(const std::pair<double,Conf>& p : found)
+            configurations.push_back(p.second);
+    }
+    else
     {
-        memcpy(currentConf, configurations[idx], sizeof(int)*isotopeNo);
-        idx++;
-        for(unsigned int ii = 0; ii < isotopeNo; ii++ )
-            for(unsigned int jj = 0; jj < isotopeNo; jj++ )
-                if( ii != jj and currentConf[jj] > 0)
-                {
-                    currentConf[ii]++;
-                    currentConf[jj]--;
+        const ConfOrderMarginalDescending orderMarginal(atom_lProbs, isotopeNo);
+
+        ConfSet visited(isotopeNo, visited_slots(atomCnt, isotopeNo, hashSize), resource->component(MEMORY_HASH_TABLES));
+
+        if(logProb(currentConf) >= lCutOff)
+        {
+            configurations.push_back(allocator.makeCopy(currentConf));
+            visited.insert(currentConf);
+        }
+
+        unsigned int idx = 0;
 
-                    if (visited.count(currentConf) == 0 and logProb(currentConf) >= lCutOff)
+        while(idx < configurations.size())
+        {
+            memcpy(currentConf, configurations[idx], sizeof(int)*isotopeNo);
+            idx++;
+            for(unsigned int ii = 0; ii < isotopeNo; ii++ )
+                for(unsigned int jj = 0; jj < isotopeNo; jj++ )
+                    if( ii != jj and currentConf[jj] > 0)
                     {
-                        visited.insert(currentConf);
-                        configurations.push_back(allocator.makeCopy(currentConf));
-                    }
+                        currentConf[ii]++;
+                        currentConf[jj]--;
 
-                    currentConf[ii]--;
-                    currentConf[jj]++;
+                        if (not visited.contains(currentConf) and logProb(currentConf) >= lCutOff)
+                        {
+                            visited.insert(currentConf);
+                            configurations.push_back(allocator.makeCopy(currentConf));
+                        }
 
-                }
-    }
+                        currentConf[ii]--;
+                        currentConf[jj]++;
+
+                    }
+        }
 
-    if(sort)
-        std::sort(configurations.begin(), configurations.end(), orderMarginal);
+        if(sort)
+            std::sort(configurations.begin(), configurations.end(), orderMarginal);
+    }
 
 
-    confs  = &configurations[0];
+    confs  = configurations.data();
     no_confs = configurations.size();
-    lProbs = new double[no_confs+1];
-    eProbs = new double[no_confs];
-    masses = new double[no_confs];
+    lProbs = eProbs = nullptr;
+    MemoryResource* const tables = resource->component(MEMORY_MARGINALS);
+    try
+    {
+        lProbs = resource_new<double>(tables, no_confs+1);
+        eProbs = resource_new<double>(tables, no_confs);
+        masses = resource_new<double>(tables, no_confs);
+    }
+    catch(...)
+    {
+        resource_delete(tables, lProbs, no_confs+1);
+        resource_delete(tables, eProbs, no_confs);
+        throw;
+    }
 
 
     for(unsigned int ii=0; ii < no_confs; ii++)
@@ -403,21 +508,24 @@ allocator(isotopeNo, tabSize)
 
 PrecalculatedMarginal::~PrecalculatedMarginal()
 {
-    if(lProbs != nullptr)
-        delete[] lProbs;
-    if(masses != nullptr)
-        delete[] masses;
-    if(eProbs != nullptr)
-        delete[] eProbs;
+    MemoryResource* const tables = resource->component(MEMORY_MARGINALS);
+    resource_delete(tables, lProbs, no_confs+1);
+    resource_delete(tables, masses, no_confs);
+    resource_delete(tables, eProbs, no_confs);
 }
 
 
 
-LayeredMarginal::LayeredMarginal(Marginal&& m, int tabSize, int _hashSize)
-: Marginal(std::move(m)), current_threshold(1.0), allocator(isotopeNo, tabSize), sorted_up_to_idx(0),
-equalizer(isotopeNo), keyHasher(isotopeNo), orderMarginal(atom_lProbs, isotopeNo), hashSize(_hashSize)
+LayeredMarginal::LayeredMarginal(Marginal&& m, int tabSize, int hashSize)
+: Marginal(std::move(m)), current_threshold(1.0),
+configurations(resource->component(MEMORY_MARGINALS)),
+fringe(KeyedConfOrder(), resource_vector<std::pair<double,Conf> >(resource->component(MEMORY_QUEUES))),
+allocator(isotopeNo, tabSize, resource->component(MEMORY_CONF_PAGES)),
+visited(isotopeNo, visited_slots(atomCnt, isotopeNo, hashSize), resource->component(MEMORY_HASH_TABLES)),
+lProbs(resource->component(MEMORY_MARGINALS)), eProbs(resource->component(MEMORY_MARGINALS)), masses(resource->component(MEMORY_MARGINALS))
 {
-    fringe.push_back(mode_conf);
+    fringe.push(std::make_pair(logProb(mode_conf), mode_conf));
+    visited.insert(mode_conf);
     lProbs.push_back(std::numeric_limits<double>::infinity());
     lProbs.push_back(-std::numeric_limits<double>::infinity());
     guarded_lProbs = lProbs.data()+1;
@@ -428,29 +536,29 @@ bool LayeredMarginal::extend(double new_threshold)
     if(fringe.empty())
         return false;
 
-    // TODO: Make sorting optional (controlled by argument?)
-    std::vector<Conf> new_fringe;
-    std::unordered_set<Conf,KeyHasher,ConfEqual> visited(hashSize,keyHasher,equalizer);
+    // The visited set only ever holds the fringe (and, for the duration of this call,
+    // the configurations accepted in it): anything at or above current_threshold is
+    // filtered out by its probability instead. The fringe is a heap, so only the part
+    // above the new threshold is touched, and since children are never more probable
+    // than their parent, configurations come out of it already sorted.
+    const unsigned int old_size = configurations.size();
 
-    for(unsigned int ii = 0; ii<fringe.size(); ii++)
-        visited.insert(fringe[ii]);
+    lProbs.pop_back(); // The guardian...
 
     double lpc, opc;
-
     Conf currentConf;
-    while(not fringe.empty())
-    {
-        currentConf = fringe.back();
-        fringe.pop_back();
-
-        opc = logProb(currentConf);
 
-        if(opc < new_threshold)
-            new_fringe.push_back(currentConf);
-
-        else
+    try
+    {
+        while(not fringe.empty() and fringe.top().first >= new_threshold)
         {
+            opc = fringe.top().first;
+            currentConf = fringe.top().second;
+            fringe.pop();
+
             configurations.push_back(currentConf);
+            lProbs.push_back(opc);
+
             for(unsigned int ii = 0; ii < isotopeNo; ii++ )
                 for(unsigned int jj = 0; jj < isotopeNo; jj++ )
                     if( ii != jj and currentConf[jj] > 0 )
@@ -460,16 +568,9 @@ bool LayeredMarginal::extend(double new_threshold)
 
                         lpc = logProb(currentConf);
 
-                        if (visited.count(currentConf) == 0 and lpc < current_threshold and
-                            (opc > lpc or (opc == lpc and ii > jj)))
-                        {
-                            Conf nc = allocator.makeCopy(currentConf);
-                            visited.insert(nc);
-                            if(lpc >= new_threshold)
-                                fringe.push_back(nc);
-                            else
-                                new_fringe.push_back(nc);
-                        }
+                        if (lpc < current_threshold and (opc > lpc or (opc == lpc and ii > jj))
+                            and visited.insert(currentConf))
+                            fringe.push(std::make_pair(lpc, allocator.makeCopy(currentConf)));
 
                         currentConf[ii]--;
                         currentConf[jj]++;
@@ -477,41 +578,33 @@ bool LayeredMarginal::extend(double new_threshold)
                     }
         }
     }
-
-    current_threshold = new_threshold;
-    fringe.swap(new_fringe);
-
-    std::sort(configurations.begin()+sorted_up_to_idx, configurations.end(), orderMarginal);
-
-    std::cout << "Marginal: lProbs.size(): " << lProbs.size() << std::endl;
-    std::cout << "Marginal: configurations.size(): " << configurations.size() << std::endl;
-
-    std::cout << "Marginal: guardian: " << lProbs[lProbs.size()-1] << std::endl;
-
-    lProbs.pop_back(); // The guardian...
-
-    for(unsigned int ii=sorted_up_to_idx; ii < configurations.size(); ii++)
+    catch(...)
     {
-        std::cout << "Marginal: looped" << std::endl;
-        lProbs.push_back(logProb(configurations[ii]));
-        eProbs.push_back(exp(lProbs.back()));
-        masses.push_back(mass(configurations[ii], atom_masses, isotopeNo));
+        // Out of memory (e.g. over a MemoryBudget): go back to the tables as they
+        // were, so that the marginal can still be read, if not extended any more
+        configurations.resize(old_size);
+        lProbs.resize(old_size+1);
+        lProbs.push_back(-std::numeric_limits<double>::infinity());
+        guarded_lProbs = lProbs.data()+1;
+        throw;
     }
 
     lProbs.push_back(-std::numeric_limits<double>::infinity()); // Restore guardian
-
-    sorted_up_to_idx = configurations.size();
     guarded_lProbs = lProbs.data()+1;
 
-    printVector(lProbs);
-    printVector(configurations);
-    printVector(masses);
+    current_threshold = new_threshold;
+
+    const unsigned int new_size = configurations.size();
 
-    std::cout << "Marginal: extended to: " << lProbs.size() << " threshold: " << new_threshold << std::endl;
-    std::cout << "Marginal: configurations extended to: " << configurations.size() << " threshold: " << new_threshold << std::endl;
+    eProbs.resize(new_size);
+    masses.resize(new_size);
 
+    for(unsigned int ii=old_size; ii < new_size; ii++)
+    {
+        visited.erase(configurations[ii]);
+        eProbs[ii] = exp(guarded_lProbs[ii]);
+        masses[ii] = mass(configurations[ii], atom_masses, isotopeNo);
+    }
 
     return true;
 }
-
-
@@ -18,16 +18,18 @@
 #ifndef MARGINALTREK_HPP
 #define MARGINALTREK_HPP
 #include <tuple>
-#include <unordered_map>
 #include <queue>
 #include <atomic>
 #include "conf.h"
+#include "arena.h"
 #include "allocator.h"
+#include "confSet.h"
 #include "operators.h"
 #include "summator.h"
 
 
-Conf initialConfigure(int atomCnt, int isotopeNo, const double* probs);
+Conf initialConfigure(int atomCnt, int isotopeNo, const double* probs, const double* lprobs,
+                      MemoryResource* resource = default_memory_resource());
 
 
 void printMarginal(const std::tuple<double*,double*,int*,int>& results, int dim);
@@ -38,16 +40,18 @@ class Marginal
 private:
     bool disowned;
 protected:
+    MemoryResource* const resource;    // of the arrays below, and those of derived classes
     const unsigned int isotopeNo;
     const unsigned int atomCnt;
-    const double* const atom_masses;
-    const double* const atom_lProbs;
+    // Set up in the body of the constructor, so that nothing leaks if that throws
+    const double* atom_masses;
+    const double* atom_lProbs;
     const double loggamma_nominator;
-    const Conf mode_conf;
-    const double mode_lprob;
-    const double mode_mass;
-    const double mode_eprob;
-    const double smallest_lprob;
+    Conf mode_conf;
+    double mode_lprob;
+    double mode_mass;
+    double mode_eprob;
+    double smallest_lprob;
 
 
 public:
@@ -55,7 +59,9 @@ public:
         const double* _masses,   // masses size = logProbs size = isotopeNo
         const double* _probs,
         int _isotopeNo,                  // No of isotope configurations.
-        int _atomCnt
+        int _atomCnt,
+        const double* _lProbs = nullptr,  // log(_probs), if known: e.g. from the element tables
+        MemoryResource* _resource = default_memory_resource()
     );
     Marginal(Marginal& other) = delete;
     Marginal& operator= (const Marginal& other) = delete;
@@ -76,17 +82,15 @@ class MarginalTrek : public Marginal
 {
 private:
     int current_count;
-    const KeyHasher keyHasher;
-    const ConfEqual equalizer;
     const ConfOrderMarginal orderMarginal;
-    std::unordered_map<Conf,int,KeyHasher,ConfEqual> visited;
-    std::priority_queue<Conf,std::vector<Conf>,ConfOrderMarginal> pq;
+    ConfSet visited;
+    std::priority_queue<Conf,resource_vector<Conf>,ConfOrderMarginal> pq;
     Summator totalProb;
     Conf candidate;
     Allocator<int> allocator;
-    std::vector<double> _conf_probs;
-    std::vector<double> _conf_masses;
-    std::vector<int*> _confs;
+    resource_vector<double> _conf_probs;
+    resource_vector<double> _conf_masses;
+    resource_vector<int*> _confs;
 
     bool add_next_conf();
 
@@ -107,9 +111,9 @@ public:
 
     int processUntilCutoff(double cutoff);
 
-    inline const std::vector<double>& conf_probs() const { return _conf_probs; };
-    inline const std::vector<double>& conf_masses() const { return _conf_masses; };
-    inline const std::vector<int*>& confs() const { return _confs; };
+    inline const resource_vector<double>& conf_probs() const { return _conf_probs; };
+    inline const resource_vector<double>& conf_masses() const { return _conf_masses; };
+    inline const resource_vector<int*>& confs() const { return _confs; };
 
 
     virtual ~MarginalTrek();
@@ -117,10 +121,21 @@ public:
 
 
 
+// Marginals with at most this many configurations in total (whether above the
+// cutoff or not) are tabulated by going through all of them, which for tiny
+// molecules is much cheaper than setting up the search and its hash table.
+// That is up to 63 atoms of a two-isotope element (C, H, N), 9 of O and 5 of S:
+// the elements of small molecules and of residues. Going through them all costs at
+// most 64 log-probabilities and one page of exactly the right size; the search
+// probes isotopeNo^2 neighbours of every configuration it keeps, and sets up a
+// hash table of hashSize slots. Past that, most configurations of a marginal fall
+// below any useful cutoff, and the search wins by never visiting them.
+#define TINY_MARGINAL_CONFS 64
+
 class PrecalculatedMarginal : public Marginal
 {
 protected:
-    std::vector<Conf> configurations;
+    resource_vector<Conf> configurations;
     Conf* confs;
     unsigned int no_confs;
     double* masses;
@@ -168,6 +183,7 @@ public:
 
 
     inline unsigned int getNextConfIdx() { return counter.fetch_add(1, std::memory_order_relaxed); };
+    inline void reset() { counter.store(0, std::memory_order_relaxed); };
     inline unsigned int getNextConfIdxwMass(double mmin, double mmax)
     {
     	unsigned int local = counter.fetch_add(1, std::memory_order_relaxed);
@@ -184,18 +200,14 @@ class LayeredMarginal : public Marginal
 {
 private:
     double current_threshold;
-    std::vector<Conf> configurations;
-    std::vector<Conf> fringe;
+    resource_vector<Conf> configurations;
+    std::priority_queue<std::pair<double,Conf>,resource_vector<std::pair<double,Conf> >,KeyedConfOrder> fringe;
     Allocator<int> allocator;
-    unsigned int sorted_up_to_idx;
-    const ConfEqual equalizer;
-    const KeyHasher keyHasher;
-    const ConfOrderMarginalDescending orderMarginal;
-    std::vector<double> lProbs;
-    std::vector<double> eProbs;
-    std::vector<double> masses;
+    ConfSet visited;
+    resource_vector<double> lProbs;
+    resource_vector<double> eProbs;
+    resource_vector<double> masses;
     double* guarded_lProbs;
-    const int hashSize;
 
 public:
     LayeredMarginal(Marginal&& m, int tabSize = 1000, int hashSize = 1000);
@@ -203,6 +215,7 @@ public:
     inline double get_lProb(int idx) const { return guarded_lProbs[idx]; }; // access to idx == -1 is valid and gives a guardian of +inf
     inline double get_eProb(int idx) const { return eProbs[idx]; };
     inline double get_mass(int idx) const { return masses[idx]; };
+    inline const double* get_lProbs_ptr() const { return guarded_lProbs; };
     inline const Conf& get_conf(int idx) const { return configurations[idx]; };
     inline unsigned int get_no_confs() const { return configurations.size(); };
 
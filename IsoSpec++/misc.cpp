@@ -18,11 +18,39 @@
 
 #include "misc.h"
 #include "lang.h"
+#include "summator.h"
 #include <stdlib.h>
+#include <cmath>
+#include <unistd.h>
+
+#ifdef __MINGW32__
+	#include <windows.h>
+#elif !defined(__APPLE__)
+	#include <sys/sysinfo.h>
+#endif
 
 #define mswap(x, y) swapspace = x; x = y; y=swapspace;
 
 
+/*
+ * Median of the first, middle and last element of the range. Deterministic and
+ * free of any global RNG state (which also keeps R happy), so it's safe to call
+ * from many threads at once.
+ */
+template<typename T, typename I, typename F> inline static I median_of_three(const T* array, I start, I end, F key)
+{
+    I mid = start + (end - start) / 2;
+    double a = key(array[start]);
+    double b = key(array[mid]);
+    double c = key(array[end-1]);
+    if(a < b)
+    {
+        if(b < c) return mid;
+        return a < c ? end-1 : start;
+    }
+    if(a < c) return start;
+    return b < c ? end-1 : mid;
+}
 
 void* quickselect(void** array, int n, int start, int end)
 {
@@ -34,12 +62,7 @@ void* quickselect(void** array, int n, int start, int end)
     while(true)
     {
         // Partition part
-        int len = end - start;
-#ifdef BUILDING_R
-        int pivot = len/2 + start;
-#else
-	int pivot = rand() % len + start;
-#endif
+        int pivot = median_of_three(array, start, end, getLProb);
         void* pval = array[pivot];
         double pprob = getLProb(pval);
         mswap(array[pivot], array[end-1]);
@@ -64,3 +87,76 @@ void* quickselect(void** array, int n, int start, int end)
     };
 }
 
+
+
+
+size_t quicktrim(size_t* idxs, const double* lprobs, const double* probs, size_t size, double needed)
+{
+    size_t swapspace;
+    size_t start = 0;
+    size_t end = size;
+    Summator taken;
+
+    while(start < end && taken.get() < needed)
+    {
+        // Three-way partition around the pivot: [start, lt) are more probable
+        // than the pivot, [lt, gt) are equal to it, [gt, end) are less probable
+        size_t pivot = median_of_three(idxs, start, end, [lprobs](size_t idx) { return lprobs[idx]; });
+        const double pprob = lprobs[idxs[pivot]];
+        size_t lt = start, ii = start, gt = end;
+        while(ii < gt)
+        {
+            if(lprobs[idxs[ii]] > pprob)
+            {
+                mswap(idxs[ii], idxs[lt]);
+                lt++; ii++;
+            }
+            else if(lprobs[idxs[ii]] < pprob)
+            {
+                gt--;
+                mswap(idxs[ii], idxs[gt]);
+            }
+            else
+                ii++;
+        }
+
+        // Selection part
+        Summator left(taken);
+        for(ii = start; ii < lt; ii++)
+            left.add(probs[idxs[ii]]);
+
+        if(left.get() >= needed)
+        {
+            end = lt;
+            continue;
+        }
+
+        // All of the more probable part is needed, the equal part is taken
+        // until we cover the target.
+        taken = left;
+        start = lt;
+        while(start < gt && taken.get() < needed)
+        {
+            taken.add(probs[idxs[start]]);
+            start++;
+        }
+        if(start < gt)
+            return start;
+        start = gt;
+    }
+
+    return start;
+}
+
+unsigned int hardware_threads()
+{
+    #ifdef __APPLE__
+        return sysconf(_SC_NPROCESSORS_ONLN);
+    #elif __MINGW32__
+        SYSTEM_INFO siSysInfo;
+        GetSystemInfo(&siSysInfo);
+        return siSysInfo.dwNumberOfProcessors;
+    #else
+        return get_nprocs();
+    #endif
+}
@@ -21,11 +21,13 @@
 #include <iostream>
 #include <tuple>
 #include <vector>
+#include <algorithm>
 #include <fenv.h>
 #include "isoMath.h"
+#include "arena.h"
 
 inline double combinedSum(
-    const int* conf, const std::vector<double>** valuesContainer, int dimNumber
+    const int* conf, const resource_vector<double>** valuesContainer, int dimNumber
 ){
     double res = 0.0;
     for(int i=0; i<dimNumber;i++)
@@ -108,10 +110,41 @@ template<typename T> void printNestedArray(const T** array, const int* shape, in
     std::cout << std::endl;
 }
 
+/*
+ * Number of leading entries of the (descending) sorted lProbs such that
+ * offset + lProbs[i] >= cutoff. The binary search result is fixed up using
+ * the very same addition the generators do, so that the answer is exact.
+ */
+inline size_t count_above_cutoff(const double* lProbs, size_t size, double offset, double cutoff)
+{
+    const double bound = cutoff - offset;
+    size_t ret = std::partition_point(lProbs, lProbs + size, [bound](double lp) { return lp >= bound; }) - lProbs;
+
+    while(ret > 0 and offset + lProbs[ret-1] < cutoff)
+        ret--;
+    while(ret < size and offset + lProbs[ret] >= cutoff)
+        ret++;
+
+    return ret;
+}
+
 #define mswap(x, y) swapspace = x; x = y; y=swapspace;
 
 void* quickselect(void** array, int n, int start, int end);
 
+/*
+ * Reorders idxs[0..size) so that its prefix is the smallest set of entries
+ * whose probabilities sum up to at least needed, with most probable entries
+ * taken first. Returns the length of that prefix (size if needed cannot be
+ * reached). Runs in expected linear time, without sorting the whole range.
+ */
+size_t quicktrim(size_t* idxs, const double* lprobs, const double* probs, size_t size, double needed);
+
+/*
+ * Number of processors available, used when no thread count was given.
+ */
+unsigned int hardware_threads();
+
 template <typename T> inline static T* array_copy(const T* A, int size)
 {
     T* ret = new T[size];
@@ -128,6 +161,14 @@ template<typename T> void dealloc_table(T* tbl, int dim)
     delete[] tbl;
 }
 
+// Same, for objects and tables from a MemoryResource
+template<typename T> void dealloc_table(MemoryResource* resource, T** tbl, int dim)
+{
+    for(int i=0; i<dim; i++)
+        resource_destroy(resource, tbl[i]);
+    resource_delete(resource, tbl, dim);
+}
+
 
 
 #endif
@@ -19,6 +19,7 @@
 #define OPERATORS_HPP
 
 #include <string.h>
+#include <utility>
 #include "conf.h"
 #include "isoMath.h"
 #include "misc.h"
@@ -97,6 +98,16 @@ public:
     };
 };
 
+class KeyedConfOrder
+{
+// (lprob, configuration) pairs comparator: only the key is looked at
+public:
+    inline bool operator()(const std::pair<double,Conf>& p1, const std::pair<double,Conf>& p2) const
+    {
+        return p1.first < p2.first;
+    };
+};
+
 template<typename T> class ReverseOrder
 {
 public:
@@ -1,17 +1,13 @@
 #include <cmath>
 #include "spectrum2.h"
+#include "misc.h"
 #include <assert.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <algorithm>
 
-#ifdef __APPLE__
-	#include <sys/mman.h>
-#elif __MINGW32__
-	#include "mman.h"
+#ifdef __MINGW32__
 	#include <windows.h>
-#else
-	#include <sys/mman.h>
-    #include <sys/sysinfo.h>
 #endif
 
 
@@ -33,18 +29,27 @@ inline static unsigned long get_mmap_len(unsigned long n_buckets)
 
 Spectrum::Spectrum(Iso&& I, double _bucket_width, double _cutoff, bool _absolute) :
 iso(std::move(I)),
-lowest_mass(I.getLightestPeakMass()),
+lowest_mass(iso.getLightestPeakMass()),
 bucket_width(_bucket_width),
-n_buckets(static_cast<unsigned int>(ceil(I.getHeaviestPeakMass()-lowest_mass)/bucket_width)),
+ptr_diff(static_cast<unsigned long>(floor(lowest_mass/bucket_width))),
+n_buckets(static_cast<unsigned long>(floor(iso.getHeaviestPeakMass()/bucket_width)) - ptr_diff + 1),
+mmap_len(get_mmap_len(n_buckets)),
 cutoff(_cutoff),
 absolute(_absolute),
 thread_idxes(0),
-ptr_diff(static_cast<unsigned int>(floor(lowest_mass/bucket_width))),
-mmap_len(get_mmap_len(n_buckets))
+total_confs(0),
+total_prob(0.0)
 {
-        PMs = I.get_MT_marginal_set(log(cutoff), absolute, 1024, 1024);
-	storage = reinterpret_cast<double*>(mmap(NULL, mmap_len, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0));
-	ofset_store = storage - ptr_diff;
+        PMs = iso.get_MT_marginal_set(log(cutoff), absolute, 1024, 1024);
+        try
+        {
+            storage = reinterpret_cast<double*>(map_pages(mmap_len));
+        }
+        catch(...)
+        {
+            iso.free_MT_marginal_set(PMs);
+            throw;
+        }
 }
 
 void* wrapper_func_thr(void* spc)
@@ -56,27 +61,23 @@ void* wrapper_func_thr(void* spc)
 void Spectrum::run(unsigned int nthreads, bool sync)
 {
     if(nthreads == 0)
-	{
-		#ifdef __APPLE__
-            nthreads = sysconf(_SC_NPROCESSORS_ONLN);
-		#elif __MINGW32__
-			SYSTEM_INFO siSysInfo;
-			GetSystemInfo(&siSysInfo); 
-			nthreads = siSysInfo.dwNumberOfProcessors;
-        #else
-            nthreads = get_nprocs();
-        #endif
-	}
+        nthreads = hardware_threads();
 
     n_threads = nthreads;
+    thread_idxes = 0;
 
     threads = new pthread_t[n_threads];
-    thread_storages = new double*[n_threads];
-    thread_partials = new double[n_threads];
-    thread_numbers = new unsigned int[n_threads];
-
-    for(unsigned int ii = 0; ii < n_threads; ii++)
-        pthread_create(&threads[ii], NULL, wrapper_func_thr, this);
+    thread_storages = new double*[n_threads]();
+    thread_partials = new double[n_threads]();
+    thread_numbers = new size_t[n_threads]();
+
+    // If the system won't start some of the threads, the others do their part;
+    // if it won't start any, the work is done right here
+    n_started = 0;
+    while(n_started < n_threads and pthread_create(&threads[n_started], NULL, wrapper_func_thr, this) == 0)
+        n_started++;
+    if(n_started == 0)
+        worker_thread();
 
     if(sync)
         wait();
@@ -84,13 +85,16 @@ void Spectrum::run(unsigned int nthreads, bool sync)
 
 void Spectrum::wait()
 {
-    for(unsigned int ii = 0; ii < n_threads; ii++)
+    for(unsigned int ii = 0; ii < n_started; ii++)
         pthread_join(threads[ii], NULL);
 
     delete[] threads;
-    dealloc_table<PrecalculatedMarginal*>(PMs, iso.getDimNumber());
+    iso.free_MT_marginal_set(PMs);
 
     calc_sum();
+
+    if(error)
+        std::rethrow_exception(error);
 }
 
 void Spectrum::calc_sum()
@@ -102,7 +106,11 @@ void Spectrum::calc_sum()
     {
         total_confs += thread_numbers[ii];
         total_prob += thread_partials[ii];
-        munmap(thread_storages[ii]+ptr_diff, mmap_len);
+        if(thread_storages[ii] == nullptr)
+            continue;   // not started, or failed
+        for(unsigned long jj = 0; jj < n_buckets; jj++)
+            storage[jj] += thread_storages[ii][jj];
+        unmap_pages(thread_storages[ii], mmap_len);
     };
 
     delete[] thread_numbers;
@@ -114,28 +122,45 @@ void Spectrum::calc_sum()
 void Spectrum::worker_thread()
 {
     unsigned int thread_id = thread_idxes.fetch_add(1);
-    IsoThresholdGeneratorMT* isoMT = new IsoThresholdGeneratorMT(std::move(iso), cutoff, PMs, absolute);
-    double* local_storage = reinterpret_cast<double*>(mmap(NULL, n_buckets*sizeof(double), PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0));
-    double* local_ofset_store = local_storage - ptr_diff;
-    double prob;
-    Summator sum;
-    unsigned int cnt = 0;
-    while(isoMT->advanceToNextConfiguration())
+    IsoThresholdGeneratorMT* isoMT = nullptr;
+    double* local_storage = nullptr;
+    try
+    {
+        isoMT = new IsoThresholdGeneratorMT(std::move(iso), cutoff, PMs, absolute);
+        // Mapped, and so first touched, by the worker itself: the pages of its
+        // histogram come from the NUMA node it runs on
+        local_storage = reinterpret_cast<double*>(map_pages(mmap_len));
+        double prob;
+        Summator sum;
+        size_t cnt = 0;
+        while(isoMT->advanceToNextConfiguration())
+        {
+            prob = isoMT->eprob();
+            // Masses of the extreme configurations may round just past the range
+            long idx = static_cast<long>(floor(isoMT->mass()/bucket_width)) - static_cast<long>(ptr_diff);
+            idx = std::max<long>(0, std::min<long>(idx, n_buckets-1));
+            local_storage[idx] += prob;
+            sum.add(prob);
+            cnt++;
+        }
+        thread_storages[thread_id] = local_storage;
+        thread_partials[thread_id] = sum.get();
+        thread_numbers[thread_id] = cnt;
+    }
+    catch(...)
     {
-        prob = isoMT->eprob();
-        local_ofset_store[static_cast<unsigned int>(floor(isoMT->mass()/bucket_width))] += prob;
-        sum.add(prob);
-        cnt++;
+        if(local_storage != nullptr)
+            unmap_pages(local_storage, mmap_len);
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if(not error)
+            error = std::current_exception();
     }
-    thread_storages[thread_id] = local_storage;
-    thread_partials[thread_id] = sum.get();
-    thread_numbers[thread_id] = cnt;
     delete isoMT;
 }
 
 Spectrum::~Spectrum()
 {
-	munmap(storage, n_buckets*sizeof(double));
+	unmap_pages(storage, mmap_len);
 }
 
 void Spectrum::add_other(Spectrum& other)
@@ -151,5 +176,5 @@ void Spectrum::add_other(Spectrum& other)
 void Spectrum::print(std::ostream& o)
 {
 	for(unsigned long ii=0; ii<n_buckets; ii++)
-	    o << lowest_mass + static_cast<double>(ii)*bucket_width << "\t" << storage[ii] << std::endl;
+	    o << first_bucket_mass() + static_cast<double>(ii)*bucket_width << "\t" << storage[ii] << std::endl;
 }
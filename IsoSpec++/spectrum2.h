@@ -1,29 +1,43 @@
+#ifndef SPECTRUM2_H
+#define SPECTRUM2_H
+
+#include <exception>
+#include <mutex>
 #include "isoSpec++.h"
 
 
 
+/*
+ * Binned spectrum of all the configurations above the cutoff, computed with
+ * IsoThresholdGeneratorMT in n threads, each summing into its own histogram.
+ * Bucket ii holds configurations of mass in [first_bucket_mass() + ii*bucket_width,
+ * first_bucket_mass() + (ii+1)*bucket_width). The marginals of iso are used up.
+ * Exceptions thrown in the workers are passed on by wait() (and so by run()).
+ */
 class Spectrum
 {
 private:
-        Iso&& iso;
+        Iso iso;
 	double lowest_mass;
 	const double bucket_width;
+        const unsigned long ptr_diff;
 	unsigned long n_buckets;
+        const unsigned long mmap_len;
 	double* storage;
-        double* ofset_store;
         pthread_t* threads;
         const double cutoff;
         PrecalculatedMarginal** PMs;
         unsigned int n_threads;
+        unsigned int n_started;         // threads actually started
         bool absolute;
         std::atomic<unsigned int> thread_idxes;
         double** thread_storages;
         double* thread_partials;
-        unsigned int* thread_numbers;
-        unsigned int total_confs;
+        size_t* thread_numbers;
+        std::mutex error_mutex;
+        std::exception_ptr error;       // the first one thrown in a worker
+        size_t total_confs;
         double total_prob;
-        const unsigned long ptr_diff;
-        const unsigned long mmap_len;
 
 public:
 	Spectrum(Iso&& I, double bucket_width, double cutoff, bool _absolute);
@@ -33,8 +47,14 @@ public:
         void worker_thread();
         void wait();
         void calc_sum();
-	inline unsigned int get_total_confs() const { return total_confs; };
+	inline size_t get_total_confs() const { return total_confs; };
         inline double get_total_prob() const { return total_prob; };
+        inline const double* get_buckets() const { return storage; };
+        inline unsigned long get_n_buckets() const { return n_buckets; };
+        inline double get_bucket_width() const { return bucket_width; };
+        inline double first_bucket_mass() const { return static_cast<double>(ptr_diff)*bucket_width; };
 	void print(std::ostream& o = std::cout);
 
 };
+
+#endif
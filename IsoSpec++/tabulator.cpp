@@ -1,87 +1,125 @@
+#include <cmath>
+#include <limits>
+#include <atomic>
+#include <pthread.h>
+#include <stdexcept>
+#include <exception>
+#include <mutex>
+#include <algorithm>
 #include "tabulator.h"
+#include "misc.h"
 
-#define INIT_TABLE_SIZE 1024
-
-#define PUSH_TO_ARRAY(array, input) \
-{ \
-    if (confs_no == current_size) \
-    { \
-        current_size *= 2; \
-        array = (double *) realloc(array, current_size * sizeof(double)); \
-    } \
-    array[confs_no] = input; \
-    confs_no++; \
+template <typename T> inline static void reallocate(T **array, size_t new_size){
+    if( *array != nullptr ){
+        *array = (T *) realloc(*array, new_size);
+    }
 }
 
-#define MEMCPY_TO_ARRAY(array, input) \
-{ \
-    if (confs_no == current_size) \
-    { \
-        current_size *= 2; \
-        array = (double *) realloc(array, current_size * sizeof(double)); \
-    } \
-    memcpy(array+confs_tbl_idx, generator->get_conf_signature(), allDimSizeOfInt) \
-    confs_tbl_idx += generator->getAllDim(); \
+template <typename T> inline static void move_chunk(T* dest, size_t offset, T* chunk, size_t size){
+    if( chunk != nullptr ){
+        memcpy(dest + offset, chunk, size * sizeof(T));
+        free(chunk);
+    }
 }
 
-void reallocate(double **array, int new_size){
-    if( *array != nullptr ){
-        *array = (double *) realloc(*array, new_size);
-    }
+template <typename T> Tabulator<T>::Tabulator(int _allDim, int confs_dim, size_t size_hint,
+                     bool get_masses, bool get_probs,
+                     bool get_lprobs, bool get_confs  ) :
+_confs_no(0), allDim(_allDim), _confs_dim(confs_dim), indices_source(nullptr), chunk_fill(0),
+chunk_size(size_hint > 0 ? size_hint : TABULATOR_INIT_CHUNK_SIZE)
+{
+    _masses = get_masses ? (double *) malloc(chunk_size * sizeof(double)) : nullptr;
+    _lprobs = get_lprobs ? (double *) malloc(chunk_size * sizeof(double)) : nullptr;
+    _probs  = get_probs  ? (double *) malloc(chunk_size * sizeof(double)) : nullptr;
+    _confs  = get_confs  ? (int *)    malloc(chunk_size * _confs_dim * sizeof(int)): nullptr;
 }
 
 // MAKE A TEMPLATE OUT OF THAT SHIT, to accept any type of generator.
 template <typename T> Tabulator<T>::Tabulator(T* generator,
                      bool get_masses, bool get_probs,
-                     bool get_lprobs, bool get_confs  )
+                     bool get_lprobs, bool get_confs,
+                     bool compress_confs ) :
+Tabulator(generator->getAllDim(),
+          compress_confs ? generator->getDimNumber() : generator->getAllDim(),
+          tabulator_size_hint(generator), get_masses, get_probs, get_lprobs, get_confs)
 {
-    int current_size = INIT_TABLE_SIZE;
-    int confs_tbl_idx = 0;
-    _confs_no = 0;
+    if(compress_confs and get_confs)
+        indices_source = generator;
 
-    const int allDimSizeOfInt = sizeof(int)*generator->getAllDim();
-
-    _masses = get_masses ? (double *) malloc(INIT_TABLE_SIZE * sizeof(double)) : nullptr;
-    _lprobs = get_lprobs ? (double *) malloc(INIT_TABLE_SIZE * sizeof(double)) : nullptr;
-    _probs  = get_probs  ? (double *) malloc(INIT_TABLE_SIZE * sizeof(double)) : nullptr;
-    _confs  = get_confs  ? (int *)    malloc(INIT_TABLE_SIZE * allDimSizeOfInt): nullptr;
+    while(generator->advanceToNextConfiguration())
+        addConf(generator);
 
+    finalize();
+}
 
-    while(generator->advanceToNextConfiguration()){
-        if( _confs_no == current_size )
-        {
-            current_size *= 2;
-            reallocate(&_masses, current_size * sizeof(double));
-            reallocate(&_lprobs, current_size * sizeof(double));
-            reallocate(&_probs,  current_size * sizeof(double));
+template <typename T> void Tabulator<T>::newChunk()
+{
+    full_chunks.push_back(TabulatorChunk{_masses, _lprobs, _probs, _confs, chunk_fill});
 
-            if( _confs != nullptr ){
-                _confs = (int *) realloc(_confs, current_size * allDimSizeOfInt);
-            }
-        }
+    if(chunk_size < TABULATOR_MAX_CHUNK_SIZE)
+        chunk_size *= 2;
+    chunk_fill = 0;
 
-        if(_masses != nullptr) _masses[_confs_no] = generator->mass();
+    // Only the tables that were asked for are non-null
+    if(_masses != nullptr) _masses = (double *) malloc(chunk_size * sizeof(double));
+    if(_lprobs != nullptr) _lprobs = (double *) malloc(chunk_size * sizeof(double));
+    if(_probs  != nullptr) _probs  = (double *) malloc(chunk_size * sizeof(double));
+    if(_confs  != nullptr) _confs  = (int *)    malloc(chunk_size * _confs_dim * sizeof(int));
+}
 
-        if(_lprobs != nullptr) _lprobs[_confs_no] = generator->lprob();
+template <typename T> void Tabulator<T>::finalize()
+{
+    if(full_chunks.empty())
+    {
+        // Everything fit in one chunk: just get rid of the slack. Keep at least
+        // one row, so that realloc never frees the tables on us.
+        const size_t size = _confs_no > 0 ? _confs_no : 1;
+        reallocate(&_masses, size * sizeof(double));
+        reallocate(&_lprobs, size * sizeof(double));
+        reallocate(&_probs,  size * sizeof(double));
+        reallocate(&_confs,  size * _confs_dim * sizeof(int));
+    }
+    else
+    {
+        full_chunks.push_back(TabulatorChunk{_masses, _lprobs, _probs, _confs, chunk_fill});
 
-        if(_probs  != nullptr) _probs[_confs_no]  = generator->eprob();
+        double* masses = _masses != nullptr ? (double *) malloc(_confs_no * sizeof(double)) : nullptr;
+        double* lprobs = _lprobs != nullptr ? (double *) malloc(_confs_no * sizeof(double)) : nullptr;
+        double* probs  = _probs  != nullptr ? (double *) malloc(_confs_no * sizeof(double)) : nullptr;
+        int*    confs  = _confs  != nullptr ? (int *)    malloc(_confs_no * _confs_dim * sizeof(int)) : nullptr;
 
-        if(_confs  != nullptr){
-            generator->get_conf_signature(_confs + confs_tbl_idx);
-            confs_tbl_idx += generator->getAllDim();
+        // Going backwards frees the most recently allocated chunks first, which
+        // lets malloc actually give the memory back as we go.
+        size_t offset = _confs_no;
+        while(not full_chunks.empty())
+        {
+            const TabulatorChunk& chunk = full_chunks.back();
+            offset -= chunk.size;
+            move_chunk(confs,  offset * _confs_dim, chunk.confs, chunk.size * _confs_dim);
+            move_chunk(probs,  offset, chunk.probs,  chunk.size);
+            move_chunk(lprobs, offset, chunk.lprobs, chunk.size);
+            move_chunk(masses, offset, chunk.masses, chunk.size);
+            full_chunks.pop_back();
         }
 
-        _confs_no++;
+        _masses = masses;
+        _lprobs = lprobs;
+        _probs  = probs;
+        _confs  = confs;
     }
 
-    _masses = (double *) realloc(_masses, _confs_no * sizeof(double));
-    _lprobs = (double *) realloc(_lprobs, _confs_no * sizeof(double));
-    _probs  = (double *) realloc(_probs,  _confs_no * sizeof(double));
-    _confs  = (int *)    realloc(_confs,  confs_tbl_idx * sizeof(int));
+    chunk_size = chunk_fill = _confs_no;
 }
 
 template <typename T> Tabulator<T>::~Tabulator()
 {
+    for(unsigned int ii = 0; ii < full_chunks.size(); ii++)
+    {
+        free(full_chunks[ii].masses);
+        free(full_chunks[ii].lprobs);
+        free(full_chunks[ii].probs);
+        free(full_chunks[ii].confs);
+    }
     if( _masses != nullptr ) free(_masses);
     if( _lprobs != nullptr ) free(_lprobs);
     if( _probs  != nullptr ) free(_probs);
@@ -90,3 +128,797 @@ template <typename T> Tabulator<T>::~Tabulator()
 
 template class Tabulator<IsoThresholdGenerator>;
 template class Tabulator<IsoLayeredGenerator>;
+template class Tabulator<IsoOrderedGenerator>;
+template class Tabulator<IsoThresholdGeneratorMT>;
+
+
+LayeredTabulator::LayeredTabulator(IsoLayeredGenerator* generator,
+                     double target_total_prob, bool optimize,
+                     bool get_masses, bool get_probs,
+                     bool get_lprobs, bool get_confs,
+                     bool compress_confs ) :
+Tabulator<IsoLayeredGenerator>(generator->getAllDim(),
+                               compress_confs ? generator->getDimNumber() : generator->getAllDim(),
+                               0, get_masses, true, true, get_confs)
+{
+    if(compress_confs and get_confs)
+        indices_source = generator;
+
+    // Probabilities are needed for the trimming regardless of what was asked for
+    Summator total;
+    Summator before_last_layer;
+    size_t layer_start;
+
+    do
+    {
+        before_last_layer = total;
+        layer_start = _confs_no;
+        while(generator->advanceToNextConfigurationWithinLayer())
+        {
+            addConf(generator);
+            total.add(generator->eprob());
+        }
+    }
+    while(total.get() < target_total_prob && generator->nextLayer(generator->get_delta()));
+
+    _total_prob = total.get();
+
+    finalize();
+
+    if(optimize && _total_prob >= target_total_prob)
+    {
+        trim(layer_start, target_total_prob - before_last_layer.get());
+        finalize();
+    }
+
+    if(!get_lprobs)
+    {
+        free(_lprobs);
+        _lprobs = nullptr;
+    }
+    if(!get_probs)
+    {
+        free(_probs);
+        _probs = nullptr;
+    }
+}
+
+void LayeredTabulator::trim(size_t layer_start, double needed)
+{
+    const size_t layer_size = _confs_no - layer_start;
+    size_t* idxs = new size_t[layer_size];
+    for(size_t ii = 0; ii < layer_size; ii++)
+        idxs[ii] = ii;
+
+    const size_t kept = quicktrim(idxs, _lprobs + layer_start, _probs + layer_start, layer_size, needed);
+
+    bool* keep = new bool[layer_size]();
+    for(size_t ii = 0; ii < kept; ii++)
+        keep[idxs[ii]] = true;
+    delete[] idxs;
+
+    // Compact the last layer in place, preserving the order of generation
+    Summator total;
+    for(size_t ii = 0; ii < layer_start; ii++)
+        total.add(_probs[ii]);
+
+    size_t wr = layer_start;
+    for(size_t rd = layer_start; rd < _confs_no; rd++)
+        if(keep[rd - layer_start])
+        {
+            if(wr != rd)
+            {
+                if(_masses != nullptr) _masses[wr] = _masses[rd];
+                _lprobs[wr] = _lprobs[rd];
+                _probs[wr] = _probs[rd];
+                if(_confs != nullptr) memcpy(_confs + wr*_confs_dim, _confs + rd*_confs_dim, _confs_dim*sizeof(int));
+            }
+            total.add(_probs[wr]);
+            wr++;
+        }
+    delete[] keep;
+
+    _confs_no = wr;
+    _total_prob = total.get();
+}
+
+
+OrderedTabulator::OrderedTabulator(IsoOrderedGenerator* generator,
+                     double target_total_prob,
+                     bool get_masses, bool get_probs,
+                     bool get_lprobs, bool get_confs,
+                     bool compress_confs ) :
+Tabulator<IsoOrderedGenerator>(generator->getAllDim(),
+                               compress_confs ? generator->getDimNumber() : generator->getAllDim(),
+                               0, get_masses, get_probs, get_lprobs, get_confs)
+{
+    if(compress_confs and get_confs)
+        indices_source = generator;
+
+    Summator total;
+
+    while(total.get() < target_total_prob && generator->advanceToNextConfiguration())
+    {
+        addConf(generator);
+        total.add(generator->eprob());
+    }
+
+    _total_prob = total.get();
+
+    finalize();
+}
+
+
+// The first exception thrown in any of the workers, to be rethrown once they are joined
+struct WorkerError
+{
+    std::mutex mutex;
+    std::exception_ptr error;
+    std::atomic<bool> failed;
+
+    WorkerError() : failed(false) {}
+
+    void record()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(not error)
+            error = std::current_exception();
+        failed = true;
+    }
+
+    void rethrow() const
+    {
+        if(error)
+            std::rethrow_exception(error);
+    }
+};
+
+struct TabulatorMTJob
+{
+    Iso* iso;
+    double threshold;
+    bool absolute;
+    PrecalculatedMarginal** PMs;
+    std::atomic<unsigned int>* next_slice;
+    size_t* offsets;
+    double* masses;
+    double* lprobs;
+    double* probs;
+    int*    confs;
+    int     confs_dim;
+    bool    compress_confs;
+    WorkerError* error;
+};
+
+// Pass one: the number of configurations in each slice
+static void* tabulator_mt_count(void* arg)
+{
+    TabulatorMTJob* job = reinterpret_cast<TabulatorMTJob*>(arg);
+    try
+    {
+        IsoThresholdGeneratorMT generator(std::move(*job->iso), job->threshold, job->PMs, job->absolute);
+        const unsigned int no_slices = job->PMs[job->iso->getDimNumber()-1]->get_no_confs();
+
+        unsigned int slice;
+        while(not job->error->failed.load(std::memory_order_relaxed) and
+              (slice = job->next_slice->fetch_add(1, std::memory_order_relaxed)) < no_slices)
+            job->offsets[slice+1] = generator.count_slice(slice);
+    }
+    catch(...)
+    {
+        job->error->record();
+    }
+
+    return NULL;
+}
+
+// Pass two: each slice is written straight into its own part of the tables
+static void* tabulator_mt_fill(void* arg)
+{
+    TabulatorMTJob* job = reinterpret_cast<TabulatorMTJob*>(arg);
+    try
+    {
+        IsoThresholdGeneratorMT generator(std::move(*job->iso), job->threshold, job->PMs, job->absolute);
+
+        unsigned int slice = std::numeric_limits<unsigned int>::max();
+        size_t pos = 0;
+        while(generator.advanceToNextConfiguration())
+        {
+            if(generator.get_slice() != slice)
+            {
+                if(job->error->failed.load(std::memory_order_relaxed))
+                    break;
+                slice = generator.get_slice();
+                pos = job->offsets[slice];
+            }
+
+            if(job->masses != nullptr) job->masses[pos] = generator.mass();
+            if(job->lprobs != nullptr) job->lprobs[pos] = generator.lprob();
+            if(job->probs  != nullptr) job->probs[pos]  = generator.eprob();
+            if(job->confs  != nullptr)
+            {
+                int* space = job->confs + pos*job->confs_dim;
+                if(job->compress_confs)
+                    generator.get_marginal_indices(space);
+                else
+                    generator.get_conf_signature(space);
+            }
+            pos++;
+        }
+    }
+    catch(...)
+    {
+        job->error->record();
+    }
+
+    return NULL;
+}
+
+// Workers share the work out among themselves, so if the system won't start some
+// of the threads, the others do their part; if it won't start any, the work is
+// done right here. Workers must not throw.
+static void run_threads(void* (*worker)(void*), void* job, unsigned int n_threads)
+{
+    std::vector<pthread_t> threads(n_threads);
+
+    unsigned int started = 0;
+    while(started < n_threads and pthread_create(&threads[started], NULL, worker, job) == 0)
+        started++;
+
+    if(started == 0)
+        worker(job);
+
+    for(unsigned int ii = 0; ii < started; ii++)
+        pthread_join(threads[ii], NULL);
+}
+
+ThresholdTabulatorMT::ThresholdTabulatorMT(Iso&& _iso, double threshold, bool absolute,
+                     unsigned int n_threads,
+                     bool get_masses, bool get_probs,
+                     bool get_lprobs, bool get_confs,
+                     int tabSize, int hashSize,
+                     bool compress_confs ) :
+Tabulator<IsoThresholdGeneratorMT>(_iso.getAllDim(),
+                                   compress_confs ? _iso.getDimNumber() : _iso.getAllDim(),
+                                   1, get_masses, get_probs, get_lprobs, get_confs),
+iso(std::move(_iso)),
+dimNumber(iso.getDimNumber()),
+expander(nullptr)
+{
+    if(n_threads == 0)
+        n_threads = hardware_threads();
+
+    const double Lcutoff = threshold > 0.0 ? log(threshold) : std::numeric_limits<double>::lowest();
+    PMs = iso.get_MT_marginal_set(Lcutoff, absolute, tabSize, hashSize);
+    SyncMarginal* last_marginal = static_cast<SyncMarginal*>(PMs[dimNumber-1]);
+    const unsigned int no_slices = last_marginal->get_no_confs();
+
+    std::atomic<unsigned int> next_slice(0);
+    std::vector<size_t> offsets(no_slices+1);
+    WorkerError error;
+
+    TabulatorMTJob job{&iso, threshold, absolute, PMs, &next_slice, offsets.data(),
+                       nullptr, nullptr, nullptr, nullptr, _confs_dim, compress_confs, &error};
+
+    try
+    {
+        run_threads(tabulator_mt_count, &job, n_threads);
+        error.rethrow();
+
+        for(unsigned int ii = 0; ii < no_slices; ii++)
+            offsets[ii+1] += offsets[ii];
+
+        _confs_no = chunk_size = chunk_fill = offsets[no_slices];
+
+        const size_t size = _confs_no > 0 ? _confs_no : 1;
+        reallocate(&_masses, size * sizeof(double));
+        reallocate(&_lprobs, size * sizeof(double));
+        reallocate(&_probs,  size * sizeof(double));
+        reallocate(&_confs,  size * _confs_dim * sizeof(int));
+
+        job.masses = _masses;
+        job.lprobs = _lprobs;
+        job.probs  = _probs;
+        job.confs  = _confs;
+
+        // The generators of the first pass have used up the shared marginal
+        last_marginal->reset();
+        run_threads(tabulator_mt_fill, &job, n_threads);
+        error.rethrow();
+    }
+    catch(...)
+    {
+        iso.free_MT_marginal_set(PMs);
+        throw;
+    }
+
+    if(compress_confs and get_confs)
+    {
+        // Only used for its view of the marginals, and of the iso
+        expander = new IsoThresholdGeneratorMT(std::move(iso), threshold, PMs, absolute);
+        indices_source = expander;
+    }
+    else
+    {
+        iso.free_MT_marginal_set(PMs);
+        PMs = nullptr;
+    }
+}
+
+ThresholdTabulatorMT::~ThresholdTabulatorMT()
+{
+    if(expander != nullptr)
+    {
+        delete expander;
+        iso.free_MT_marginal_set(PMs);
+    }
+}
+
+
+struct BatchBlock
+{
+    unsigned int thread;
+    size_t start;           // rows and conf ints already in the thread's output
+    size_t conf_start;
+};
+
+struct BatchOutput
+{
+    std::vector<double> masses;
+    std::vector<double> lprobs;
+    std::vector<double> probs;
+    std::vector<int>    confs;
+    size_t rows;
+    std::exception_ptr error;
+};
+
+struct BatchJob
+{
+    // Either formulas, or the rest
+    const char* const* formulas;
+    int dimNumber;
+    const int* isotopeNumbers;
+    const int* atomCounts;
+    const double* const * isotopeMasses;
+    const double* const * isotopeProbabilities;
+
+    size_t molecules_no;
+    double threshold;
+    bool absolute;
+    bool get_masses, get_probs, get_lprobs, get_confs;
+
+    std::atomic<unsigned int> next_thread;
+    std::atomic<size_t> next_block;
+    std::atomic<bool> failed;
+    size_t* counts;         // rows and conf ints of each molecule
+    size_t* conf_counts;
+    BatchBlock* blocks;
+    BatchOutput* outputs;
+};
+
+static void* batch_worker(void* arg)
+{
+    BatchJob* job = reinterpret_cast<BatchJob*>(arg);
+    const unsigned int thread = job->next_thread.fetch_add(1);
+    BatchOutput& out = job->outputs[thread];
+    const size_t no_blocks = (job->molecules_no + BATCH_BLOCK_SIZE - 1) / BATCH_BLOCK_SIZE;
+
+    // All the state of each molecule's Iso and generator lives here, reset in between
+    Arena arena;
+
+    size_t block;
+    while((block = job->next_block.fetch_add(1, std::memory_order_relaxed)) < no_blocks)
+    {
+        if(job->failed.load(std::memory_order_relaxed))
+            break;
+
+        job->blocks[block] = BatchBlock{thread, out.rows, out.confs.size()};
+        const size_t end = std::min<size_t>((block+1)*BATCH_BLOCK_SIZE, job->molecules_no);
+
+        for(size_t ii = block*BATCH_BLOCK_SIZE; ii < end; ii++)
+        {
+            try
+            {
+                IsoThresholdGenerator generator(job->formulas != nullptr ?
+                                                    Iso(job->formulas[ii], &arena) :
+                                                    Iso(job->dimNumber, job->isotopeNumbers,
+                                                        job->atomCounts + ii*job->dimNumber,
+                                                        job->isotopeMasses, job->isotopeProbabilities, &arena),
+                                                job->threshold, job->absolute);
+                const int allDim = generator.getAllDim();
+                const size_t start = out.rows;
+                const size_t conf_start = out.confs.size();
+
+                while(generator.advanceToNextConfiguration())
+                {
+                    if(job->get_masses) out.masses.push_back(generator.mass());
+                    if(job->get_lprobs) out.lprobs.push_back(generator.lprob());
+                    if(job->get_probs)  out.probs.push_back(generator.eprob());
+                    if(job->get_confs)
+                    {
+                        out.confs.resize(out.confs.size() + allDim);
+                        generator.get_conf_signature(out.confs.data() + out.confs.size() - allDim);
+                    }
+                    out.rows++;
+                }
+
+                job->counts[ii] = out.rows - start;
+                job->conf_counts[ii] = out.confs.size() - conf_start;
+            }
+            catch(...)
+            {
+                out.error = std::current_exception();
+                job->failed = true;
+                return NULL;
+            }
+            arena.reset();
+        }
+    }
+
+    return NULL;
+}
+
+template <typename T> inline static T* batch_column(bool requested, size_t size)
+{
+    return requested ? reinterpret_cast<T*>(malloc((size > 0 ? size : 1) * sizeof(T))) : nullptr;
+}
+
+template <typename T> inline static void batch_copy(T* dest, const std::vector<T>& src, size_t from, size_t count)
+{
+    if(dest != nullptr and count > 0)
+        memcpy(dest, src.data() + from, count * sizeof(T));
+}
+
+BatchThresholdTabulator::BatchThresholdTabulator(const char* const* formulas, size_t molecules_no,
+                     double threshold, bool absolute,
+                     unsigned int n_threads,
+                     bool get_masses, bool get_probs,
+                     bool get_lprobs, bool get_confs ) :
+_masses(nullptr), _lprobs(nullptr), _probs(nullptr), _confs(nullptr),
+_offsets(nullptr), _conf_offsets(nullptr), _molecules_no(molecules_no)
+{
+    BatchJob job{formulas, 0, nullptr, nullptr, nullptr, nullptr,
+                 molecules_no, threshold, absolute, get_masses, get_probs, get_lprobs, get_confs,
+                 {0}, {0}, {false}, nullptr, nullptr, nullptr, nullptr};
+    run(job, n_threads, get_masses, get_probs, get_lprobs, get_confs);
+}
+
+BatchThresholdTabulator::BatchThresholdTabulator(size_t molecules_no,
+                     int dimNumber,
+                     const int* isotopeNumbers,
+                     const int* atomCounts,
+                     const double* const * isotopeMasses,
+                     const double* const * isotopeProbabilities,
+                     double threshold, bool absolute,
+                     unsigned int n_threads,
+                     bool get_masses, bool get_probs,
+                     bool get_lprobs, bool get_confs ) :
+_masses(nullptr), _lprobs(nullptr), _probs(nullptr), _confs(nullptr),
+_offsets(nullptr), _conf_offsets(nullptr), _molecules_no(molecules_no)
+{
+    BatchJob job{nullptr, dimNumber, isotopeNumbers, atomCounts, isotopeMasses, isotopeProbabilities,
+                 molecules_no, threshold, absolute, get_masses, get_probs, get_lprobs, get_confs,
+                 {0}, {0}, {false}, nullptr, nullptr, nullptr, nullptr};
+    run(job, n_threads, get_masses, get_probs, get_lprobs, get_confs);
+}
+
+void BatchThresholdTabulator::run(BatchJob& job, unsigned int n_threads,
+                     bool get_masses, bool get_probs,
+                     bool get_lprobs, bool get_confs)
+{
+    if(n_threads == 0)
+        n_threads = hardware_threads();
+
+    const size_t no_blocks = (_molecules_no + BATCH_BLOCK_SIZE - 1) / BATCH_BLOCK_SIZE;
+    if(n_threads > no_blocks)
+        n_threads = no_blocks > 0 ? no_blocks : 1;
+
+    std::vector<size_t> counts(_molecules_no);
+    std::vector<size_t> conf_counts(_molecules_no);
+    std::vector<BatchBlock> blocks(no_blocks);
+    std::vector<BatchOutput> outputs(n_threads);
+    for(BatchOutput& out : outputs)
+        out.rows = 0;
+
+    job.counts = counts.data();
+    job.conf_counts = conf_counts.data();
+    job.blocks = blocks.data();
+    job.outputs = outputs.data();
+
+    run_threads(batch_worker, &job, n_threads);
+
+    // Rethrown as they were: invalid formulas as invalid_argument, the rest as themselves
+    for(const BatchOutput& out : outputs)
+        if(out.error)
+            std::rethrow_exception(out.error);
+
+    _offsets = new size_t[_molecules_no+1];
+    _conf_offsets = new size_t[_molecules_no+1];
+    _offsets[0] = _conf_offsets[0] = 0;
+    for(size_t ii = 0; ii < _molecules_no; ii++)
+    {
+        _offsets[ii+1] = _offsets[ii] + counts[ii];
+        _conf_offsets[ii+1] = _conf_offsets[ii] + conf_counts[ii];
+    }
+
+    _masses = batch_column<double>(get_masses, confs_no());
+    _lprobs = batch_column<double>(get_lprobs, confs_no());
+    _probs  = batch_column<double>(get_probs,  confs_no());
+    _confs  = batch_column<int>(get_confs, _conf_offsets[_molecules_no]);
+
+    // Blocks are contiguous both in the output of their thread and in the result
+    for(size_t block = 0; block < no_blocks; block++)
+    {
+        const BatchBlock& b = blocks[block];
+        const BatchOutput& out = outputs[b.thread];
+        const size_t first = block*BATCH_BLOCK_SIZE;
+        const size_t last = std::min<size_t>(first + BATCH_BLOCK_SIZE, _molecules_no);
+        const size_t rows = _offsets[last] - _offsets[first];
+
+        batch_copy(_masses + (_masses != nullptr ? _offsets[first] : 0), out.masses, b.start, rows);
+        batch_copy(_lprobs + (_lprobs != nullptr ? _offsets[first] : 0), out.lprobs, b.start, rows);
+        batch_copy(_probs  + (_probs  != nullptr ? _offsets[first] : 0), out.probs,  b.start, rows);
+        batch_copy(_confs  + (_confs  != nullptr ? _conf_offsets[first] : 0), out.confs, b.conf_start,
+                   _conf_offsets[last] - _conf_offsets[first]);
+    }
+}
+
+BatchThresholdTabulator::~BatchThresholdTabulator()
+{
+    free(_masses);
+    free(_lprobs);
+    free(_probs);
+    free(_confs);
+    delete[] _offsets;
+    delete[] _conf_offsets;
+}
+
+
+FixedDistribution::FixedDistribution(const char* _formula, double _threshold, bool _absolute) :
+formula(_formula),
+threshold(_threshold),
+absolute(_absolute)
+{
+    IsoThresholdGenerator generator(Iso(_formula), threshold, absolute);
+    allDim = generator.getAllDim();
+
+    std::vector<double> masses, lprobs;
+    std::vector<int> confs;
+    while(generator.advanceToNextConfiguration())
+    {
+        masses.push_back(generator.mass());
+        lprobs.push_back(generator.lprob());
+        confs.resize(confs.size() + allDim);
+        generator.get_conf_signature(confs.data() + confs.size() - allDim);
+    }
+
+    std::vector<size_t> order(masses.size());
+    for(size_t ii=0; ii<order.size(); ii++)
+        order[ii] = ii;
+    std::sort(order.begin(), order.end(), [&lprobs](size_t a, size_t b) { return lprobs[a] > lprobs[b]; });
+
+    _masses.reserve(order.size());
+    _lprobs.reserve(order.size());
+    _probs.reserve(order.size());
+    _confs.reserve(confs.size());
+    for(size_t ii : order)
+    {
+        _masses.push_back(masses[ii]);
+        _lprobs.push_back(lprobs[ii]);
+        _probs.push_back(exp(lprobs[ii]));
+        _confs.insert(_confs.end(), confs.begin() + ii*allDim, confs.begin() + (ii+1)*allDim);
+    }
+}
+
+const FixedDistribution& FixedDistribution::check(const char* _formula, double _threshold, bool _absolute) const
+{
+    if(formula != _formula or threshold != _threshold or absolute != _absolute)
+        throw std::logic_error("FixedDistribution of " + formula + " requested with different arguments");
+    return *this;
+}
+
+
+#define TABULATOR_FILE_BUFFER_SIZE (1024*1024)
+#define TABULATOR_FILE_ALIGNMENT 64
+
+inline static uint64_t file_align(uint64_t offset)
+{
+    return (offset + TABULATOR_FILE_ALIGNMENT - 1) / TABULATOR_FILE_ALIGNMENT * TABULATOR_FILE_ALIGNMENT;
+}
+
+inline static void file_seek(FILE* file, uint64_t offset)
+{
+#ifdef __MINGW32__
+    const int ret = _fseeki64(file, offset, SEEK_SET);
+#else
+    const int ret = fseeko(file, offset, SEEK_SET);
+#endif
+    if(ret != 0)
+        throw std::runtime_error("Could not seek in the output file");
+}
+
+inline static void file_write(FILE* file, const void* data, size_t size)
+{
+    if(fwrite(data, 1, size, file) != size)
+        throw std::runtime_error("Could not write to the output file");
+}
+
+/*
+ * Buffered writer of a single column: either straight into the result file, at
+ * the column's place, or into a temporary file to be copied over later.
+ */
+class TabulatorFileColumn
+{
+private:
+    FILE* file;
+    char* buffer;
+    size_t buffer_fill;
+    size_t buffer_size;
+
+public:
+    const size_t elem_size;
+    const bool spilled;
+    uint64_t offset;
+
+    TabulatorFileColumn(const char* path, uint64_t _offset, size_t _elem_size) :
+    file(nullptr), buffer(nullptr), buffer_fill(0), elem_size(_elem_size),
+    spilled(path == nullptr), offset(_offset)
+    {
+        buffer_size = elem_size * (TABULATOR_FILE_BUFFER_SIZE / elem_size + 1);
+        buffer = new char[buffer_size];
+
+        file = spilled ? tmpfile() : fopen(path, "r+b");
+        if(file == nullptr)
+            throw std::runtime_error("Could not open the output file");
+
+        if(not spilled)
+            file_seek(file, offset);
+    }
+
+    ~TabulatorFileColumn()
+    {
+        if(file != nullptr)
+            fclose(file);
+        delete[] buffer;
+    }
+
+    // Space for the next row
+    inline void* next()
+    {
+        if(buffer_fill == buffer_size)
+            flush();
+        void* ret = buffer + buffer_fill;
+        buffer_fill += elem_size;
+        return ret;
+    }
+
+    void flush()
+    {
+        file_write(file, buffer, buffer_fill);
+        buffer_fill = 0;
+    }
+
+    // Flushes, and for spilled columns copies the data into place in dest
+    void close(FILE* dest)
+    {
+        flush();
+        if(spilled)
+        {
+            rewind(file);
+            file_seek(dest, offset);
+            size_t read;
+            while((read = fread(buffer, 1, buffer_size, file)) > 0)
+                file_write(dest, buffer, read);
+            if(ferror(file))
+                throw std::runtime_error("Could not read back a temporary file");
+        }
+        if(fclose(file) != 0)
+            throw std::runtime_error("Could not write to the output file");
+        file = nullptr;
+    }
+};
+
+template <typename T> FileTabulator<T>::FileTabulator(T* generator, const char* path,
+                     bool get_masses, bool get_probs,
+                     bool get_lprobs, bool get_confs  ) :
+file(nullptr), _confs_no(0), allDim(generator->getAllDim())
+{
+    for(int ii = 0; ii < 4; ii++)
+        columns[ii] = nullptr;
+
+    try
+    {
+        file = fopen(path, "wb");
+        if(file == nullptr)
+            throw std::runtime_error("Could not open the output file");
+
+        const size_t size_hint = tabulator_size_hint(generator);
+        const char* direct_path = size_hint > 0 ? path : nullptr;
+
+        // Where the columns go, if we already know it
+        uint64_t offset = file_align(sizeof(TabulatorFileHeader));
+        const bool wanted[4] = {get_masses, get_lprobs, get_probs, get_confs};
+        for(int ii = 0; ii < 4; ii++)
+            if(wanted[ii])
+            {
+                const size_t elem_size = ii < 3 ? sizeof(double) : allDim * sizeof(int);
+                columns[ii] = new TabulatorFileColumn(direct_path, offset, elem_size);
+                offset = file_align(offset + size_hint * elem_size);
+            }
+
+        while(generator->advanceToNextConfiguration())
+        {
+            if(size_hint > 0 and _confs_no == size_hint)
+                throw std::logic_error("The generator produced more configurations than announced");
+
+            if(columns[0] != nullptr) *reinterpret_cast<double*>(columns[0]->next()) = generator->mass();
+            if(columns[1] != nullptr) *reinterpret_cast<double*>(columns[1]->next()) = generator->lprob();
+            if(columns[2] != nullptr) *reinterpret_cast<double*>(columns[2]->next()) = generator->eprob();
+            if(columns[3] != nullptr) generator->get_conf_signature(reinterpret_cast<int*>(columns[3]->next()));
+            _confs_no++;
+        }
+
+        finish();
+    }
+    catch(...)
+    {
+        cleanup();
+        throw;
+    }
+}
+
+template <typename T> void FileTabulator<T>::finish()
+{
+    TabulatorFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TABULATOR_FILE_MAGIC, sizeof(header.magic));
+    header.version = TABULATOR_FILE_VERSION;
+    header.confs_dim = allDim;
+    header.confs_no = _confs_no;
+
+    uint64_t offset = file_align(sizeof(TabulatorFileHeader));
+    for(int ii = 0; ii < 4; ii++)
+        if(columns[ii] != nullptr)
+        {
+            if(columns[ii]->spilled)
+            {
+                columns[ii]->offset = offset;
+                offset = file_align(offset + _confs_no * columns[ii]->elem_size);
+            }
+            columns[ii]->close(file);
+            header.offsets[ii] = columns[ii]->offset;
+            delete columns[ii];
+            columns[ii] = nullptr;
+        }
+
+    file_seek(file, 0);
+    file_write(file, &header, sizeof(header));
+
+    const int ret = fclose(file);
+    file = nullptr;
+    if(ret != 0)
+        throw std::runtime_error("Could not write to the output file");
+}
+
+template <typename T> FileTabulator<T>::~FileTabulator()
+{
+    cleanup();
+}
+
+template <typename T> void FileTabulator<T>::cleanup()
+{
+    for(int ii = 0; ii < 4; ii++)
+    {
+        delete columns[ii];
+        columns[ii] = nullptr;
+    }
+    if(file != nullptr)
+    {
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+template class FileTabulator<IsoThresholdGenerator>;
+template class FileTabulator<IsoLayeredGenerator>;
+template class FileTabulator<IsoOrderedGenerator>;
@@ -1,28 +1,332 @@
 #ifndef __TABULATOR_H__
 #define __TABULATOR_H__
 
+#include <vector>
+#include <string>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
 #include "isoSpec++.h"
 
+// Results are gathered in chunks that are never relocated, and put together into
+// contiguous tables only once, at the end. Chunks are freed as they get copied
+// over, so the memory used doesn't go much above the size of the final result.
+// If the generator can cheaply tell how many configurations it will produce,
+// the tables are allocated once, with the exact size, and no copying happens.
+#define TABULATOR_INIT_CHUNK_SIZE 1024
+#define TABULATOR_MAX_CHUNK_SIZE (64*1024)
+
+struct TabulatorChunk
+{
+    double* masses;
+    double* lprobs;
+    double* probs;
+    int*    confs;
+    size_t  size;
+};
+
+// Number of configurations the generator is going to produce, or 0 if unknown
+inline static size_t tabulator_size_hint(IsoGenerator*) { return 0; }
+inline static size_t tabulator_size_hint(IsoThresholdGenerator* generator) { return generator->count_confs(); }
+
 template <typename T> class Tabulator
 {
-private:
+protected:
     double* _masses;
     double* _lprobs;
     double* _probs;
     int*    _confs;
-    int     _confs_no;
+    size_t  _confs_no;
+    int     allDim;
+    int     _confs_dim;         // ints per row of _confs: allDim, or dimNumber if compressed
+    const T* indices_source;    // generator the marginal indices refer to, if compressed
+    size_t  chunk_fill;
+    size_t  chunk_size;
+    std::vector<TabulatorChunk> full_chunks;
+
+    Tabulator(int _allDim, int confs_dim, size_t size_hint,
+              bool get_masses, bool get_probs,
+              bool get_lprobs, bool get_confs);
+
+    inline void addConf(T* generator)
+    {
+        if( chunk_fill == chunk_size )
+            newChunk();
+
+        if(_masses != nullptr) _masses[chunk_fill] = generator->mass();
+
+        if(_lprobs != nullptr) _lprobs[chunk_fill] = generator->lprob();
+
+        if(_probs  != nullptr) _probs[chunk_fill]  = generator->eprob();
+
+        if(_confs  != nullptr)
+        {
+            int* space = _confs + chunk_fill*_confs_dim;
+            if(indices_source != nullptr)
+                generator->get_marginal_indices(space);
+            else
+                generator->get_conf_signature(space);
+        }
+
+        chunk_fill++;
+        _confs_no++;
+    }
+
+    void newChunk();
+    void finalize();
+
 public:
+    // With compress_confs, confs() holds the indices of the configurations in the
+    // marginals of the generator, which then has to outlive the tabulator.
     Tabulator(T* generator,
               bool get_masses, bool get_probs,
-              bool get_lprobs, bool get_confs);
+              bool get_lprobs, bool get_confs,
+              bool compress_confs = false);
 
-    ~Tabulator();
+    virtual ~Tabulator();
 
     inline double*   masses()   { return _masses; };
     inline double*   lprobs()   { return _lprobs; };
     inline double*   probs()    { return _probs; };
     inline int*      confs()    { return _confs; };
-    inline int       confs_no() { return _confs_no; };
+    inline size_t    confs_no() { return _confs_no; };
+    inline int       confs_dim() { return _confs_dim; };
+    inline bool      confs_compressed() { return indices_source != nullptr; };
+
+    // Full isotope counts of the idx-th configuration, however they are stored
+    inline void get_conf_signature(size_t idx, int* space) const
+    {
+        const int* row = _confs + idx*_confs_dim;
+        if(indices_source != nullptr)
+            indices_source->expand_conf(row, space);
+        else
+            memcpy(space, row, allDim*sizeof(int));
+    }
+};
+
+
+/*
+ * Fixed table of the optimal p-set: the smallest set of configurations whose
+ * total probability reaches target_total_prob. Layers are tabulated in full until
+ * the target is covered, then (if optimize is set) only the last layer is trimmed.
+ */
+class LayeredTabulator : public Tabulator<IsoLayeredGenerator>
+{
+private:
+    double _total_prob;
+
+    void trim(size_t layer_start, double needed);
+
+public:
+    LayeredTabulator(IsoLayeredGenerator* generator,
+                     double target_total_prob, bool optimize,
+                     bool get_masses, bool get_probs,
+                     bool get_lprobs, bool get_confs,
+                     bool compress_confs = false);
+
+    inline double total_prob() const { return _total_prob; };
+};
+
+
+/*
+ * Configurations in the order of decreasing probability, until their total
+ * probability reaches target_total_prob (or the generator runs out of them).
+ */
+class OrderedTabulator : public Tabulator<IsoOrderedGenerator>
+{
+private:
+    double _total_prob;
+
+public:
+    OrderedTabulator(IsoOrderedGenerator* generator,
+                     double target_total_prob,
+                     bool get_masses, bool get_probs,
+                     bool get_lprobs, bool get_confs,
+                     bool compress_confs = false);
+
+    inline double total_prob() const { return _total_prob; };
+};
+
+
+/*
+ * Multithreaded threshold tabulation, in two passes. First the configurations
+ * in each slice (see IsoThresholdGeneratorMT) are counted, which tells where
+ * each slice goes in the output, and then threads write their slices straight
+ * into place. The order of the result does not depend on the number of threads.
+ * The tabulator takes over iso, whose marginals are used up in the process.
+ * With compress_confs, it keeps them for expanding the indices.
+ */
+class ThresholdTabulatorMT : public Tabulator<IsoThresholdGeneratorMT>
+{
+private:
+    Iso iso;
+    PrecalculatedMarginal** PMs;
+    int dimNumber;
+    IsoThresholdGeneratorMT* expander;
+
+public:
+    ThresholdTabulatorMT(Iso&& _iso, double threshold, bool absolute,
+                         unsigned int n_threads,
+                         bool get_masses, bool get_probs,
+                         bool get_lprobs, bool get_confs,
+                         int tabSize = 1000, int hashSize = 1000,
+                         bool compress_confs = false);
+
+    virtual ~ThresholdTabulatorMT();
+};
+
+
+/*
+ * Threshold enumeration of many molecules at once, in n_threads (0: one per
+ * processor), each taking blocks of molecules in turn. Molecules are given either
+ * as formulas, or as rows of atomCounts (molecules_no x dimNumber) over shared
+ * isotope data, as in Iso's constructor. Results of all the molecules are put
+ * together, in the order of the input: those of molecule ii are rows offsets()[ii]
+ * to offsets()[ii+1] of the columns, and its confs start at conf_offsets()[ii]
+ * (formulas may differ in the number of isotopes, and so in the size of a conf).
+ * Throws std::invalid_argument if any of the formulas can't be parsed.
+ */
+#define BATCH_BLOCK_SIZE 64
+
+struct BatchJob;
+
+class BatchThresholdTabulator
+{
+private:
+    double* _masses;
+    double* _lprobs;
+    double* _probs;
+    int*    _confs;
+    size_t* _offsets;
+    size_t* _conf_offsets;
+    size_t  _molecules_no;
+
+    void run(BatchJob& job, unsigned int n_threads,
+             bool get_masses, bool get_probs,
+             bool get_lprobs, bool get_confs);
+
+public:
+    BatchThresholdTabulator(const char* const* formulas, size_t molecules_no,
+                            double threshold, bool absolute,
+                            unsigned int n_threads,
+                            bool get_masses, bool get_probs,
+                            bool get_lprobs, bool get_confs);
+
+    BatchThresholdTabulator(size_t molecules_no,
+                            int dimNumber,
+                            const int* isotopeNumbers,
+                            const int* atomCounts,
+                            const double* const * isotopeMasses,
+                            const double* const * isotopeProbabilities,
+                            double threshold, bool absolute,
+                            unsigned int n_threads,
+                            bool get_masses, bool get_probs,
+                            bool get_lprobs, bool get_confs);
+
+    ~BatchThresholdTabulator();
+
+    inline double*       masses()       { return _masses; };
+    inline double*       lprobs()       { return _lprobs; };
+    inline double*       probs()        { return _probs; };
+    inline int*          confs()        { return _confs; };
+    inline const size_t* offsets()      { return _offsets; };
+    inline const size_t* conf_offsets() { return _conf_offsets; };
+    inline size_t        molecules_no() { return _molecules_no; };
+    inline size_t        confs_no()     { return _offsets[_molecules_no]; };
+};
+
+
+/*
+ * The distribution of a fixed species (water, adducts, reagents, residues...):
+ * all the configurations above the threshold, most probable first. Meant to be
+ * computed once and kept, see ISO_FIXED_DISTRIBUTION.
+ */
+class FixedDistribution
+{
+private:
+    std::vector<double> _masses;
+    std::vector<double> _lprobs;
+    std::vector<double> _probs;
+    std::vector<int>    _confs;
+    int                 allDim;
+    std::string         formula;
+    double              threshold;
+    bool                absolute;
+
+public:
+    FixedDistribution(const char* formula, double threshold, bool absolute = true);
+
+    // Returns *this if it was made from these arguments, throws std::logic_error otherwise
+    const FixedDistribution& check(const char* formula, double threshold, bool absolute = true) const;
+
+    inline const double* masses() const   { return _masses.data(); };
+    inline const double* lprobs() const   { return _lprobs.data(); };
+    inline const double* probs() const    { return _probs.data(); };
+    inline const int*    confs() const    { return _confs.data(); };
+    inline size_t        confs_no() const { return _masses.size(); };
+    inline int           getAllDim() const { return allDim; };
+};
+
+// C++11 can't evaluate the distribution at compile time (nor take the formula as
+// a template argument), so each use of this macro gets its own static table,
+// filled on first use (thread-safely) and only checked afterwards:
+//     const FixedDistribution& water = ISO_FIXED_DISTRIBUTION("H2O", 1e-6);
+// formula and threshold must be the same on every call from a given use site:
+// a call with different ones throws std::logic_error instead of returning a
+// table for other arguments.
+#define ISO_FIXED_DISTRIBUTION(formula, threshold) \
+    ([](const char* _f, double _t) -> const FixedDistribution& \
+     { static const FixedDistribution d(_f, _t); return d.check(_f, _t); }((formula), (threshold)))
+
+
+/*
+ * Results written to a file instead of memory, for enumerations that don't fit
+ * in RAM. The file consists of a header, followed by each requested column as
+ * one contiguous array (in native byte order), starting at the offset given in
+ * the header: masses, lprobs, probs (double[confs_no]) and confs
+ * (int[confs_no * confs_dim]). Missing columns have offset 0. Columns start at
+ * multiples of 64 bytes, so the file can be mapped as is, e.g. with numpy.memmap.
+ *
+ * If the generator can tell how many configurations it will produce, columns
+ * are written straight into place. Otherwise they are spilled to temporary
+ * files first and copied into the result at the end.
+ */
+#define TABULATOR_FILE_MAGIC "IsoSpecT"
+#define TABULATOR_FILE_VERSION 1
+
+struct TabulatorFileHeader
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t confs_dim;
+    uint64_t confs_no;
+    uint64_t offsets[4];    // masses, lprobs, probs, confs
+    uint64_t reserved;
+};
+
+class TabulatorFileColumn;
+
+template <typename T> class FileTabulator
+{
+private:
+    FILE* file;
+    TabulatorFileColumn* columns[4];
+    size_t _confs_no;
+    int allDim;
+
+    void add_column(int which, size_t elem_size, size_t size_hint);
+    void finish();
+    void cleanup();
+
+public:
+    // Throws std::runtime_error if the file can't be written
+    FileTabulator(T* generator, const char* path,
+                  bool get_masses, bool get_probs,
+                  bool get_lprobs, bool get_confs);
+
+    ~FileTabulator();
+
+    inline size_t confs_no() const { return _confs_no; };
 };
 
 #endif  // __TABULATOR_H__
@@ -8,7 +8,11 @@
 #include "marginalTrek++.cpp"
 #include "operators.cpp"
 #include "element_tables.cpp"
+#include "arena.cpp"
+#include "confSet.cpp"
+#include "isotopeLabels.cpp"
 #include "misc.cpp"
 #include "spectrum2.cpp"
 #include "cwrapper.cpp"
 #include "tabulator.cpp"
+#include "arrowWriter.cpp"
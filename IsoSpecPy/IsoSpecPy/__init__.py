@@ -16,7 +16,6 @@
 # 
 
 from .isoFFI import isoFFI
-import re
 import types
 from . import PeriodicTbl
 from .confs_passthrough import ConfsPassthrough
@@ -27,24 +26,50 @@ try:
 except NameError:
     xrange = range
 
-regex_pattern = re.compile('([A-Z][a-z]?)([0-9]*)')
+def RegisterIsotopeLabel(name, element, spec):
+    """Register a named isotope label of the element, e.g. ("SILAC", "C", "13C=0.99"),
+    to be used in formulas as C[SILAC]6. Isotopes not given in spec share what
+    is left in their natural proportions."""
+    if isoFFI.clib.registerIsotopeLabel(name.encode('ascii'), element.encode('ascii'), spec.encode('ascii')) != 0:
+        raise ValueError("Invalid isotope label")
+
+def LabelledProbs(symbol, label):
+    """Isotope abundances of the element under the label: a registered name or
+    a spec such as "13C=0.99"."""
+    isotope_no = len(PeriodicTbl.symbol_to_probs[symbol])
+    space = isoFFI.ffi.new("double[]", isotope_no)
+    if isoFFI.clib.isotopeLabelProbabilities(symbol.encode('ascii'), label.encode('ascii'), space, isotope_no) != isotope_no:
+        raise ValueError("Invalid isotope label")
+    return tuple(space)
+
+def SetHugePages(enabled = True):
+    """Back large tables (binned spectra, and those of the molecules created from
+    now on) with transparent huge pages, where the system supports them."""
+    isoFFI.clib.setHugePages(enabled)
+
+max_isotope_no = max(len(p) for p in PeriodicTbl.symbol_to_probs.values())
 
 def IsoParamsFromFormula(formula):
-    global regex_pattern
-
-    symbols = []
-    atomCounts = []
-    for elem, cnt in re.findall(regex_pattern, formula):
-        symbols.append(elem)
-        atomCounts.append(int(cnt) if cnt is not '' else 1)
-    try:
-        masses = tuple(PeriodicTbl.symbol_to_masses[s] for s in symbols)
-        probs  = tuple(PeriodicTbl.symbol_to_probs[s]  for s in symbols)
-        isotopeNumbers = tuple(len(PeriodicTbl.symbol_to_probs[s]) for s in symbols)
-    except KeyError:
+    """Parses the formula with the C++ parser, as IsoThresholdBatch does."""
+    ffi = isoFFI.ffi
+    max_elements = len(formula)
+    max_isotopes = max_elements * max_isotope_no
+    isotopeNumbers = ffi.new("int[]", max_elements)
+    atomCounts = ffi.new("int[]", max_elements)
+    masses = ffi.new("double[]", max_isotopes)
+    probs = ffi.new("double[]", max_isotopes)
+
+    dimNumber = isoFFI.clib.parseFormula(formula.encode('ascii'), isotopeNumbers, atomCounts, masses, probs,
+                                         max_elements, max_isotopes)
+    if dimNumber < 0:
         raise ValueError("Invalid formula")
 
-    return (len(atomCounts), isotopeNumbers, atomCounts, masses, probs)
+    starts = [sum(isotopeNumbers[0:i]) for i in xrange(dimNumber+1)]
+    return (dimNumber,
+            tuple(isotopeNumbers[0:dimNumber]),
+            list(atomCounts[0:dimNumber]),
+            tuple(tuple(masses[starts[i]:starts[i+1]]) for i in xrange(dimNumber)),
+            tuple(tuple(probs[starts[i]:starts[i+1]]) for i in xrange(dimNumber)))
 
 
 
@@ -119,7 +144,43 @@ class Iso(object):
 
 
 
-class IsoThreshold(Iso):
+class TabulatorView(object):
+    """Exposes memory of a tabulator to numpy without copying. Arrays made from it
+    keep a reference to it, and so to the owner of the tabulator."""
+    def __init__(self, owner, ptr, dtype, shape):
+        self.owner = owner
+        self.__array_interface__ = {'version': 3,
+                                    'shape': shape,
+                                    'typestr': dtype.str,
+                                    'data': (int(isoFFI.ffi.cast("uintptr_t", ptr)), True)}
+
+
+class NumpyResults(object):
+    """Read-only numpy views of the results, valid for as long as they are referenced:
+    np_confs() has one row of isotope counts (get_confs is needed) per configuration."""
+    def _view(self, ptr, dtype, shape):
+        import numpy as np
+        dtype = np.dtype(dtype)
+        if self.size == 0:
+            return np.empty(shape, dtype = dtype)
+        return np.asarray(TabulatorView(self, ptr, dtype, shape))
+
+    def np_masses(self):
+        return self._view(self.masses, 'float64', (self.size,))
+
+    def np_lprobs(self):
+        return self._view(self.lprobs, 'float64', (self.size,))
+
+    def np_probs(self):
+        return self._view(self.probs, 'float64', (self.size,))
+
+    def np_confs(self):
+        if not self.get_confs:
+            raise ValueError("Configurations were not requested (get_confs = False)")
+        return self._view(self.raw_confs, 'intc', (self.size, self.sum_isotope_numbers))
+
+
+class IsoThreshold(Iso, NumpyResults):
     def __init__(self, threshold, absolute=False, get_confs = False, **kwargs):
         self.tabulator = None
         self.generator = None
@@ -128,7 +189,10 @@ class IsoThreshold(Iso):
         self.absolute = absolute
 
         self.generator = self.ffi.setupIsoThresholdGenerator(self.iso, threshold, absolute, 1000, 1000)
-        self.tabulator = self.ffi.setupThresholdTabulator(self.generator, True, True, True, get_confs)
+        self.tabulator = self.ffi.setupThresholdTabulator(self.generator, True, True, True, get_confs, False)
+        if self.tabulator == isoFFI.ffi.NULL:
+            self.tabulator = None
+            raise MemoryError("Could not tabulate the configurations")
 
         self.size = self.ffi.confs_noThresholdTabulator(self.tabulator)
 
@@ -160,40 +224,327 @@ class IsoThreshold(Iso):
 
 
 
-'''
-
-class IsoLayered(Iso):
-    def __init__(self, delta=-10.0, **kwargs):
-        super(IsoLayered, self).__init__(**kwargs)
+class IsoLayered(Iso, NumpyResults):
+    def __init__(self, prob_to_cover, get_confs = False, delta = -3.0, optimize = True, **kwargs):
+        self.tabulator = None
+        self.generator = None
+        assert delta < 0.0
+        super(IsoLayered, self).__init__(get_confs = get_confs, **kwargs)
+        self.prob_to_cover = prob_to_cover
         self.delta = delta
+        self.optimize = optimize
 
-    def __iter__(self):
-        return IsoLayeredGenerator(src=self, get_confs=self.get_confs)
+        self.generator = self.ffi.setupIsoLayeredGenerator(self.iso, delta, 1000, 1000)
+        self.tabulator = self.ffi.setupLayeredTabulator(self.generator, prob_to_cover, optimize, True, True, True, get_confs, False)
+        if self.tabulator == isoFFI.ffi.NULL:
+            self.tabulator = None
+            raise MemoryError("Could not tabulate the configurations")
+
+        self.size = self.ffi.confs_noLayeredTabulator(self.tabulator)
+        self.total_prob = self.ffi.total_probLayeredTabulator(self.tabulator)
+
+        def c(typename, what, mult = 1):
+            return isoFFI.ffi.cast(typename + '[' + str(self.size*mult) + ']', what)
+
+        self.masses = c("double", self.ffi.massesLayeredTabulator(self.tabulator))
+        self.lprobs = c("double", self.ffi.lprobsLayeredTabulator(self.tabulator))
+        self.probs  = c("double", self.ffi.probsLayeredTabulator(self.tabulator))
+
+        if get_confs:
+            self.sum_isotope_numbers = sum(self.isotopeNumbers)
+            self.raw_confs = c("int", self.ffi.confsLayeredTabulator(self.tabulator), mult = self.sum_isotope_numbers)
+            self.confs = ConfsPassthrough(lambda idx: self._get_conf(idx), self.size)
+
+
+    def _get_conf(self, idx):
+        return self.parse_conf(self.raw_confs, starting_with = self.sum_isotope_numbers * idx)
+
+    def __len__(self):
+        return self.size
+
+    def __del__(self):
+        if self.tabulator is not None:
+            self.ffi.deleteLayeredTabulator(self.tabulator)
+        if self.generator is not None:
+            self.ffi.deleteIsoLayeredGenerator(self.generator)
+
+
+class IsoThresholdMT(Iso, NumpyResults):
+    """Same as IsoThreshold, computed in n_threads (0: one per processor). The result,
+    including its order, doesn't depend on the number of threads. The GIL is released
+    for the whole computation."""
+    def __init__(self, threshold, absolute=False, get_confs = False, n_threads = 0, **kwargs):
+        self.tabulator = None
+        super(IsoThresholdMT, self).__init__(get_confs = get_confs, **kwargs)
+        self.threshold = threshold
+        self.absolute = absolute
+
+        self.tabulator = self.ffi.setupThresholdTabulatorMT(self.iso, threshold, absolute, n_threads, True, True, True, get_confs, False, 1000, 1000)
+        if self.tabulator == isoFFI.ffi.NULL:
+            self.tabulator = None
+            raise MemoryError("Could not tabulate the configurations")
+
+        self.size = self.ffi.confs_noThresholdTabulatorMT(self.tabulator)
+
+        def c(typename, what, mult = 1):
+            return isoFFI.ffi.cast(typename + '[' + str(self.size*mult) + ']', what)
+
+        self.masses = c("double", self.ffi.massesThresholdTabulatorMT(self.tabulator))
+        self.lprobs = c("double", self.ffi.lprobsThresholdTabulatorMT(self.tabulator))
+        self.probs  = c("double", self.ffi.probsThresholdTabulatorMT(self.tabulator))
+
+        if get_confs:
+            self.sum_isotope_numbers = sum(self.isotopeNumbers)
+            self.raw_confs = c("int", self.ffi.confsThresholdTabulatorMT(self.tabulator), mult = self.sum_isotope_numbers)
+            self.confs = ConfsPassthrough(lambda idx: self._get_conf(idx), self.size)
+
+    def _get_conf(self, idx):
+        return self.parse_conf(self.raw_confs, starting_with = self.sum_isotope_numbers * idx)
+
+    def __len__(self):
+        return self.size
 
     def __del__(self):
-        pass
+        if self.tabulator is not None:
+            self.ffi.deleteThresholdTabulatorMT(self.tabulator)
+
+
+class IsoThresholdBatch(object):
+    """Threshold tabulation of many molecules in one call, in n_threads (0: one per
+    processor). Molecules are given either as formulas, or as elements (a list of
+    symbols) and atomCounts (one row of counts per molecule). Results are
+    concatenated numpy views (np_masses, np_probs, np_lprobs, np_confs); those of
+    molecule i are rows np_offsets()[i] to np_offsets()[i+1], and its confs start
+    at np_conf_offsets()[i]. self[i] gives the masses and probs of molecule i."""
+    def __init__(self, threshold, formulas=None, absolute=False, get_confs=False, n_threads=0, elements=None, atomCounts=None):
+        self.tabulator = None
+        self.ffi = isoFFI.clib
+        self.threshold = threshold
+        self.absolute = absolute
+        self.get_confs = get_confs
+        ffi = isoFFI.ffi
+
+        if formulas is not None:
+            cformulas = [ffi.new("char[]", f.encode()) for f in formulas]
+            self.molecules_no = len(cformulas)
+            self.tabulator = self.ffi.setupBatchThresholdTabulator(ffi.new("char*[]", cformulas), self.molecules_no,
+                                                                   threshold, absolute, n_threads, True, True, True, get_confs)
+            if self.tabulator == ffi.NULL:
+                self.tabulator = None
+                raise ValueError("Invalid formula")
+        elif elements is not None and atomCounts is not None:
+            try:
+                masses = [PeriodicTbl.symbol_to_masses[e] for e in elements]
+                probs  = [PeriodicTbl.symbol_to_probs[e]  for e in elements]
+            except KeyError:
+                raise ValueError("Invalid element")
+            counts = [c for row in atomCounts for c in row]
+            self.molecules_no = len(counts) // len(elements)
+            if self.molecules_no * len(elements) != len(counts):
+                raise ValueError("Each row of atomCounts must have one count per element")
+            self.tabulator = self.ffi.setupBatchThresholdTabulatorFromCounts(self.molecules_no, len(elements),
+                                                                             [len(m) for m in masses], counts,
+                                                                             [x for m in masses for x in m],
+                                                                             [x for p in probs for x in p],
+                                                                             threshold, absolute, n_threads, True, True, True, get_confs)
+            if self.tabulator == ffi.NULL:
+                self.tabulator = None
+                raise ValueError("Invalid atom counts")
+        else:
+            raise Exception("Either formulas, or both elements and atomCounts must not be None")
+
+        self.size = self.ffi.confs_noBatchThresholdTabulator(self.tabulator)
+
+    def _view(self, ptr, dtype, size):
+        import numpy as np
+        dtype = np.dtype(dtype)
+        if size == 0:
+            return np.empty((0,), dtype = dtype)
+        return np.asarray(TabulatorView(self, ptr, dtype, (size,)))
+
+    def np_offsets(self):
+        return self._view(self.ffi.offsetsBatchThresholdTabulator(self.tabulator), 'uintp', self.molecules_no + 1)
+
+    def np_conf_offsets(self):
+        return self._view(self.ffi.conf_offsetsBatchThresholdTabulator(self.tabulator), 'uintp', self.molecules_no + 1)
+
+    def np_masses(self):
+        return self._view(self.ffi.massesBatchThresholdTabulator(self.tabulator), 'float64', self.size)
+
+    def np_lprobs(self):
+        return self._view(self.ffi.lprobsBatchThresholdTabulator(self.tabulator), 'float64', self.size)
+
+    def np_probs(self):
+        return self._view(self.ffi.probsBatchThresholdTabulator(self.tabulator), 'float64', self.size)
+
+    def np_confs(self):
+        if not self.get_confs:
+            raise ValueError("Configurations were not requested (get_confs = False)")
+        return self._view(self.ffi.confsBatchThresholdTabulator(self.tabulator), 'intc', int(self.np_conf_offsets()[-1]))
+
+    def __len__(self):
+        return self.molecules_no
+
+    def __getitem__(self, idx):
+        offsets = self.np_offsets()
+        return (self.np_masses()[offsets[idx]:offsets[idx+1]], self.np_probs()[offsets[idx]:offsets[idx+1]])
+
+    def __del__(self):
+        if self.tabulator is not None:
+            self.ffi.deleteBatchThresholdTabulator(self.tabulator)
+
+
+class IsoBinnedSpectrum(Iso):
+    """Total probabilities of the configurations above the threshold, binned by mass,
+    computed in n_threads (0: one per processor) with the GIL released. Bucket i covers
+    masses from first_bucket_mass + i*bucket_width, for bucket_width."""
+    def __init__(self, threshold, bucket_width, absolute=False, n_threads = 0, **kwargs):
+        self.spectrum = None
+        super(IsoBinnedSpectrum, self).__init__(**kwargs)
+        self.threshold = threshold
+        self.absolute = absolute
+        self.bucket_width = bucket_width
+
+        self.spectrum = self.ffi.setupSpectrum(self.iso, bucket_width, threshold, absolute, n_threads)
+        if self.spectrum == isoFFI.ffi.NULL:
+            self.spectrum = None
+            raise MemoryError("Could not compute the spectrum")
+
+        self.size = self.ffi.n_bucketsSpectrum(self.spectrum)
+        self.first_bucket_mass = self.ffi.first_bucket_massSpectrum(self.spectrum)
+        self.total_confs = self.ffi.total_confsSpectrum(self.spectrum)
+        self.total_prob = self.ffi.total_probSpectrum(self.spectrum)
+        self.probs = isoFFI.ffi.cast('double[' + str(self.size) + ']', self.ffi.bucketsSpectrum(self.spectrum))
+
+    def np_probs(self):
+        import numpy as np
+        return np.asarray(TabulatorView(self, self.probs, np.dtype('float64'), (self.size,)))
+
+    def np_masses(self):
+        import numpy as np
+        return self.first_bucket_mass + self.bucket_width * np.arange(self.size)
+
+    def __len__(self):
+        return self.size
+
+    def __del__(self):
+        if self.spectrum is not None:
+            self.ffi.deleteSpectrum(self.spectrum)
+
+
+def IsoThresholdToFile(path, threshold, absolute=False, get_confs=False, **kwargs):
+    """Writes the configurations above the threshold into a file instead of memory,
+    for results too large to fit in RAM. Returns their number. Use LoadTabulatedFile
+    to read it back."""
+    iso = Iso(get_confs = get_confs, **kwargs)
+    generator = iso.ffi.setupIsoThresholdGenerator(iso.iso, threshold, absolute, 1000, 1000)
+    try:
+        ret = iso.ffi.tabulateToFileIsoThresholdGenerator(generator, path.encode(), True, True, True, get_confs)
+    finally:
+        iso.ffi.deleteIsoThresholdGenerator(generator)
+    if ret < 0:
+        raise IOError("Could not write " + path)
+    return ret
+
+
+def IsoThresholdToArrow(path, threshold, absolute=False, get_confs=False, file_format=True, **kwargs):
+    """Writes the configurations above the threshold in the Apache Arrow IPC format,
+    with columns mass, prob, lprob and (if get_confs) conf. Writes an Arrow file, or a
+    stream if file_format is False. Returns the number of configurations."""
+    iso = Iso(get_confs = get_confs, **kwargs)
+    generator = iso.ffi.setupIsoThresholdGenerator(iso.iso, threshold, absolute, 1000, 1000)
+    try:
+        ret = iso.ffi.writeArrowIsoThresholdGenerator(generator, path.encode(), file_format, True, True, True, get_confs)
+    finally:
+        iso.ffi.deleteIsoThresholdGenerator(generator)
+    if ret < 0:
+        raise IOError("Could not write " + path)
+    return ret
+
+
+def LoadTabulatedFile(path):
+    """Maps a file written by IsoThresholdToFile (or FileTabulator) into memory, without
+    copying. Returns a dict of numpy arrays: masses, lprobs, probs (those that were
+    written) and confs, with one row of isotope counts per configuration."""
+    import struct
+    import numpy as np
+
+    header_fmt = '=8sIIQ4QQ'
+    with open(path, 'rb') as f:
+        header = f.read(struct.calcsize(header_fmt))
+    magic, version, confs_dim, confs_no, o_masses, o_lprobs, o_probs, o_confs, _ = struct.unpack(header_fmt, header)
+    if magic != b'IsoSpecT' or version != 1:
+        raise ValueError(path + " is not an IsoSpec result file")
+
+    ret = {}
+    for name, offset, dtype, shape in (('masses', o_masses, np.float64, (confs_no,)),
+                                       ('lprobs', o_lprobs, np.float64, (confs_no,)),
+                                       ('probs',  o_probs,  np.float64, (confs_no,)),
+                                       ('confs',  o_confs,  np.intc,    (confs_no, confs_dim))):
+        if offset != 0:
+            ret[name] = np.memmap(path, dtype = dtype, mode = 'r', offset = offset, shape = shape) if confs_no > 0 else np.empty(shape, dtype = dtype)
+    return ret
 
-'''
 
 class IsoGenerator(Iso):
-    def __init__(self, get_confs=False, **kwargs):
+    def __init__(self, get_confs=False, chunk_size=10000, **kwargs):
         self.cgen = None
         super(IsoGenerator, self).__init__(get_confs = get_confs, **kwargs)
-        self.conf_space = isoFFI.ffi.new("int[" + str(sum(self.isotopeNumbers)) + "]")
+        self.sum_isotope_numbers = sum(self.isotopeNumbers)
+        self.chunk_size = chunk_size
         self.firstuse = True
 
-    def __iter__(self):
+    def _chunks(self, chunk_size, use_lists):
+        # Configurations are pulled from C++ chunk_size at a time, into buffers
+        # that are reused, so each chunk is copied out before the next one is read
         if not self.firstuse:
             raise NotImplementedError("Multiple iterations through the same IsoGenerator object are not supported. Either create a new (identical) generator for a second loop-through, or use one of the non-generator classes, which do support being re-used.")
         self.firstuse = False
+        ffi = isoFFI.ffi
         cgen = self.cgen
-        if self.get_confs:
-            while self.advancer(cgen):
-                self.conf_getter(cgen, self.conf_space)
-                yield (self.mass_getter(cgen), self.lprob_getter(cgen), self.parse_conf(self.conf_space))
-        else:
-            while self.advancer(cgen):
-                yield (self.mass_getter(cgen), self.lprob_getter(cgen))
+        masses = ffi.new("double[]", chunk_size)
+        lprobs = ffi.new("double[]", chunk_size)
+        confs = ffi.new("int[]", chunk_size * self.sum_isotope_numbers) if self.get_confs else ffi.NULL
+        if not use_lists:
+            import numpy as np
+        while True:
+            rows = self.chunk_getter(cgen, chunk_size, masses, ffi.NULL, lprobs, confs)
+            if rows > 0:
+                if use_lists:
+                    yield (ffi.unpack(masses, rows), ffi.unpack(lprobs, rows), ffi.unpack(confs, rows * self.sum_isotope_numbers) if self.get_confs else None)
+                else:
+                    yield (np.frombuffer(ffi.buffer(masses, rows * 8), dtype = np.float64).copy(),
+                           np.frombuffer(ffi.buffer(lprobs, rows * 8), dtype = np.float64).copy(),
+                           np.frombuffer(ffi.buffer(confs, rows * ffi.sizeof("int") * self.sum_isotope_numbers), dtype = np.intc).reshape(rows, self.sum_isotope_numbers).copy() if self.get_confs else None)
+            if rows < chunk_size:
+                return
+
+    def iter_chunks(self, chunk_size=None):
+        """Yields the configurations in numpy arrays of (up to) chunk_size rows: tuples
+        of masses, lprobs and, if get_confs was set, a 2-D array of isotope counts."""
+        for masses, lprobs, confs in self._chunks(chunk_size or self.chunk_size, False):
+            if self.get_confs:
+                yield (masses, lprobs, confs)
+            else:
+                yield (masses, lprobs)
+
+    def __iter__(self):
+        for masses, lprobs, confs in self._chunks(self.chunk_size, True):
+            if self.get_confs:
+                dim = self.sum_isotope_numbers
+                for i in xrange(len(masses)):
+                    yield (masses[i], lprobs[i], self.parse_conf(confs, starting_with = i * dim))
+            else:
+                for pair in zip(masses, lprobs):
+                    yield pair
+
+    # In the order of MemoryComponent
+    memory_components = ("iso", "marginals", "conf_pages", "hash_tables", "queues", "generator", "total")
+
+    def memory_usage(self):
+        """Bytes taken by the generator so far, by component: a dict of (current, peak) pairs."""
+        return dict((name, (self.memory_used_getter(self.cgen, idx), self.memory_peak_getter(self.cgen, idx)))
+                    for idx, name in enumerate(self.memory_components))
 
         
 
@@ -211,6 +562,9 @@ class IsoThresholdGenerator(IsoGenerator):
         self.lprob_getter = self.ffi.lprobIsoThresholdGenerator
         self.mass_getter = self.ffi.massIsoThresholdGenerator
         self.conf_getter = self.ffi.get_conf_signatureIsoThresholdGenerator
+        self.chunk_getter = self.ffi.nextChunkIsoThresholdGenerator
+        self.memory_used_getter = self.ffi.memoryUsedIsoThresholdGenerator
+        self.memory_peak_getter = self.ffi.memoryPeakIsoThresholdGenerator
 
     def __del__(self):
         if self.cgen is not None:
@@ -230,6 +584,9 @@ class IsoLayeredGenerator(IsoGenerator):
         self.lprob_getter = self.ffi.lprobIsoLayeredGenerator
         self.mass_getter = self.ffi.massIsoLayeredGenerator
         self.conf_getter = self.ffi.get_conf_signatureIsoLayeredGenerator
+        self.chunk_getter = self.ffi.nextChunkIsoLayeredGenerator
+        self.memory_used_getter = self.ffi.memoryUsedIsoLayeredGenerator
+        self.memory_peak_getter = self.ffi.memoryPeakIsoLayeredGenerator
 
     def __del__(self):
         if self.cgen is not None:
@@ -245,6 +602,9 @@ class IsoOrderedGenerator(IsoGenerator):
         self.lprob_getter = self.ffi.lprobIsoOrderedGenerator
         self.mass_getter = self.ffi.massIsoOrderedGenerator
         self.conf_getter = self.ffi.get_conf_signatureIsoOrderedGenerator
+        self.chunk_getter = self.ffi.nextChunkIsoOrderedGenerator
+        self.memory_used_getter = self.ffi.memoryUsedIsoOrderedGenerator
+        self.memory_peak_getter = self.ffi.memoryPeakIsoOrderedGenerator
 
     def __del__(self):
         if self.cgen is not None:
@@ -15,14 +15,29 @@ class IsoFFI:
                 const double* isotopeMasses,
                 const double* isotopeProbabilities);
 
+        void * setupIsoFromElements(int dimNumber,
+                const int* atomicNumbers,
+                const int* atomCounts);
+
         void deleteIso(void* iso);
 
+        int registerIsotopeLabel(const char* name, const char* element, const char* spec);
+        int isotopeLabelProbabilities(const char* element, const char* label, double* space, int space_size);
+        int parseFormula(const char* formula, int* isotopeNumbers, int* atomCounts, double* isotopeMasses, double* isotopeProbabilities, int max_elements, int max_isotopes);
+        void setHugePages(bool enabled);
+
+        typedef bool (*chunk_callback)(void* user_data, int rows);
+
         void* setupIsoThresholdGenerator(void* iso,
                                          double threshold,
                                          bool _absolute,
                                          int _tabSize,
                                          int _hashSize);
         double massIsoThresholdGenerator(void* generator); double lprobIsoThresholdGenerator(void* generator); void methodIsoThresholdGenerator(void* generator); bool advanceToNextConfigurationIsoThresholdGenerator(void* generator); void deleteIsoThresholdGenerator(void* generator); void get_conf_signatureIsoThresholdGenerator(void* generator, int* space);
+        int nextChunkIsoThresholdGenerator(void* generator, int max_rows, double* masses, double* probs, double* lprobs, int* confs);
+        long long streamChunksIsoThresholdGenerator(void* generator, int max_rows, double* masses, double* probs, double* lprobs, int* confs, chunk_callback callback, void* user_data);
+        size_t memoryUsedIsoThresholdGenerator(void* generator, int component);
+        size_t memoryPeakIsoThresholdGenerator(void* generator, int component);
 
 
 
@@ -31,18 +46,41 @@ class IsoFFI:
                                        int _tabSize,
                                        int _hashSize);
         double massIsoLayeredGenerator(void* generator); double lprobIsoLayeredGenerator(void* generator); void methodIsoLayeredGenerator(void* generator); bool advanceToNextConfigurationIsoLayeredGenerator(void* generator); void deleteIsoLayeredGenerator(void* generator); void get_conf_signatureIsoLayeredGenerator(void* generator, int* space);
+        int nextChunkIsoLayeredGenerator(void* generator, int max_rows, double* masses, double* probs, double* lprobs, int* confs);
+        long long streamChunksIsoLayeredGenerator(void* generator, int max_rows, double* masses, double* probs, double* lprobs, int* confs, chunk_callback callback, void* user_data);
+        size_t memoryUsedIsoLayeredGenerator(void* generator, int component);
+        size_t memoryPeakIsoLayeredGenerator(void* generator, int component);
 
 
         void* setupIsoOrderedGenerator(void* iso,
                                        int _tabSize,
                                        int _hashSize);
         double massIsoOrderedGenerator(void* generator); double lprobIsoOrderedGenerator(void* generator); void methodIsoOrderedGenerator(void* generator); bool advanceToNextConfigurationIsoOrderedGenerator(void* generator); void deleteIsoOrderedGenerator(void* generator); void get_conf_signatureIsoOrderedGenerator(void* generator, int* space);
+        int nextChunkIsoOrderedGenerator(void* generator, int max_rows, double* masses, double* probs, double* lprobs, int* confs);
+        long long streamChunksIsoOrderedGenerator(void* generator, int max_rows, double* masses, double* probs, double* lprobs, int* confs, chunk_callback callback, void* user_data);
+        size_t memoryUsedIsoOrderedGenerator(void* generator, int component);
+        size_t memoryPeakIsoOrderedGenerator(void* generator, int component);
+
+
+        void* setupThresholdMTMarginals(void* iso,
+                                        double threshold,
+                                        bool _absolute,
+                                        int _tabSize,
+                                        int _hashSize);
+        void deleteThresholdMTMarginals(void* marginals);
+        void* setupIsoThresholdGeneratorMT(void* marginals);
+        double massIsoThresholdGeneratorMT(void* generator); double lprobIsoThresholdGeneratorMT(void* generator); void methodIsoThresholdGeneratorMT(void* generator); bool advanceToNextConfigurationIsoThresholdGeneratorMT(void* generator); void deleteIsoThresholdGeneratorMT(void* generator); void get_conf_signatureIsoThresholdGeneratorMT(void* generator, int* space);
+        int nextChunkIsoThresholdGeneratorMT(void* generator, int max_rows, double* masses, double* probs, double* lprobs, int* confs);
+        long long streamChunksIsoThresholdGeneratorMT(void* generator, int max_rows, double* masses, double* probs, double* lprobs, int* confs, chunk_callback callback, void* user_data);
+        size_t memoryUsedIsoThresholdGeneratorMT(void* generator, int component);
+        size_t memoryPeakIsoThresholdGeneratorMT(void* generator, int component);
 
         void* setupThresholdTabulator(void* generator,
                                       bool get_masses,
                                       bool get_probs,
                                       bool get_lprobs,
-                                      bool get_confs);
+                                      bool get_confs,
+                                    bool compress_confs);
 
         void deleteThresholdTabulator(void* tabulator);
 
@@ -50,7 +88,97 @@ class IsoFFI:
         const double* lprobsThresholdTabulator(void* tabulator);
         const double* probsThresholdTabulator(void* tabulator);
         const int* confsThresholdTabulator(void* tabulator);
-        int confs_noThresholdTabulator(void* tabulator);
+        size_t confs_noThresholdTabulator(void* tabulator);
+        int confs_dimThresholdTabulator(void* tabulator);
+        void get_conf_signatureThresholdTabulator(void* tabulator, size_t idx, int* space);
+
+        void* setupLayeredTabulator(void* generator,
+                                    double target_total_prob,
+                                    bool optimize,
+                                    bool get_masses,
+                                    bool get_probs,
+                                    bool get_lprobs,
+                                    bool get_confs,
+                                    bool compress_confs);
+
+        void deleteLayeredTabulator(void* tabulator);
+
+        const double* massesLayeredTabulator(void* tabulator);
+        const double* lprobsLayeredTabulator(void* tabulator);
+        const double* probsLayeredTabulator(void* tabulator);
+        const int* confsLayeredTabulator(void* tabulator);
+        size_t confs_noLayeredTabulator(void* tabulator);
+        int confs_dimLayeredTabulator(void* tabulator);
+        void get_conf_signatureLayeredTabulator(void* tabulator, size_t idx, int* space);
+        double total_probLayeredTabulator(void* tabulator);
+
+        void* setupOrderedTabulator(void* generator,
+                                    double target_total_prob,
+                                    bool get_masses,
+                                    bool get_probs,
+                                    bool get_lprobs,
+                                    bool get_confs,
+                                    bool compress_confs);
+
+        void deleteOrderedTabulator(void* tabulator);
+
+        const double* massesOrderedTabulator(void* tabulator);
+        const double* lprobsOrderedTabulator(void* tabulator);
+        const double* probsOrderedTabulator(void* tabulator);
+        const int* confsOrderedTabulator(void* tabulator);
+        size_t confs_noOrderedTabulator(void* tabulator);
+        int confs_dimOrderedTabulator(void* tabulator);
+        void get_conf_signatureOrderedTabulator(void* tabulator, size_t idx, int* space);
+        double total_probOrderedTabulator(void* tabulator);
+
+        void* setupThresholdTabulatorMT(void* iso,
+                                        double threshold,
+                                        bool _absolute,
+                                        int n_threads,
+                                        bool get_masses,
+                                        bool get_probs,
+                                        bool get_lprobs,
+                                        bool get_confs,
+                                        bool compress_confs,
+                                        int _tabSize,
+                                        int _hashSize);
+
+        void deleteThresholdTabulatorMT(void* tabulator);
+
+        const double* massesThresholdTabulatorMT(void* tabulator);
+        const double* lprobsThresholdTabulatorMT(void* tabulator);
+        const double* probsThresholdTabulatorMT(void* tabulator);
+        const int* confsThresholdTabulatorMT(void* tabulator);
+        size_t confs_noThresholdTabulatorMT(void* tabulator);
+        int confs_dimThresholdTabulatorMT(void* tabulator);
+        void get_conf_signatureThresholdTabulatorMT(void* tabulator, size_t idx, int* space);
+
+        void* setupBatchThresholdTabulator(const char* const* formulas, size_t molecules_no, double threshold, bool _absolute, int n_threads, bool get_masses, bool get_probs, bool get_lprobs, bool get_confs);
+        void* setupBatchThresholdTabulatorFromCounts(size_t molecules_no, int dimNumber, const int* isotopeNumbers, const int* atomCounts, const double* isotopeMasses, const double* isotopeProbabilities, double threshold, bool _absolute, int n_threads, bool get_masses, bool get_probs, bool get_lprobs, bool get_confs);
+        void deleteBatchThresholdTabulator(void* tabulator);
+        const double* massesBatchThresholdTabulator(void* tabulator);
+        const double* lprobsBatchThresholdTabulator(void* tabulator);
+        const double* probsBatchThresholdTabulator(void* tabulator);
+        const int* confsBatchThresholdTabulator(void* tabulator);
+        const size_t* offsetsBatchThresholdTabulator(void* tabulator);
+        const size_t* conf_offsetsBatchThresholdTabulator(void* tabulator);
+        size_t confs_noBatchThresholdTabulator(void* tabulator);
+
+        void* setupSpectrum(void* iso, double bucket_width, double threshold, bool _absolute, int n_threads);
+        void deleteSpectrum(void* spectrum);
+        const double* bucketsSpectrum(void* spectrum);
+        long long n_bucketsSpectrum(void* spectrum);
+        double first_bucket_massSpectrum(void* spectrum);
+        long long total_confsSpectrum(void* spectrum);
+        double total_probSpectrum(void* spectrum);
+
+        long long tabulateToFileIsoThresholdGenerator(void* generator, const char* path, bool get_masses, bool get_probs, bool get_lprobs, bool get_confs);
+        long long tabulateToFileIsoLayeredGenerator(void* generator, const char* path, bool get_masses, bool get_probs, bool get_lprobs, bool get_confs);
+        long long tabulateToFileIsoOrderedGenerator(void* generator, const char* path, bool get_masses, bool get_probs, bool get_lprobs, bool get_confs);
+
+        long long writeArrowIsoThresholdGenerator(void* generator, const char* path, bool file_format, bool get_masses, bool get_probs, bool get_lprobs, bool get_confs);
+        long long writeArrowIsoLayeredGenerator(void* generator, const char* path, bool file_format, bool get_masses, bool get_probs, bool get_lprobs, bool get_confs);
+        long long writeArrowIsoOrderedGenerator(void* generator, const char* path, bool file_format, bool get_masses, bool get_probs, bool get_lprobs, bool get_confs);
 
         #define NUMBER_OF_ISOTOPIC_ENTRIES 287
         extern const int elem_table_atomicNo[NUMBER_OF_ISOTOPIC_ENTRIES];
@@ -16,14 +16,41 @@
 
 
 #include <Rcpp.h>
-#include "cwrapper.h"
-#include "misc.h"
-#include "isoSpec++.h"
 #include <vector>
-#include <iostream>
+#include <algorithm>
+// The engine is built from the shared IsoSpec++ sources (see ../configure)
+#include "IsoSpec++/unity-build.cpp"
 
 using namespace Rcpp;
 
+
+// R matrices are column-major, so masses and log-probabilities are copied over
+// as whole columns; isotope counts are transposed one column at a time.
+template <typename T> static NumericMatrix tabulator_to_matrix(T& tabulator, int allDim,
+                                                               const CharacterVector& tags, bool showCounts)
+{
+    const size_t confsNo = tabulator.confs_no();
+    NumericMatrix res(confsNo, tags.size());
+
+    std::copy(tabulator.masses(), tabulator.masses() + confsNo, res.begin());
+    std::copy(tabulator.lprobs(), tabulator.lprobs() + confsNo, res.begin() + confsNo);
+
+    if( showCounts )
+    {
+        const int* confs = tabulator.confs();
+        for(int k=0; k<allDim; k++)
+        {
+            NumericMatrix::iterator column = res.begin() + (2+k)*confsNo;
+            for(size_t i=0; i<confsNo; i++)
+                column[i] = confs[i*allDim + k];
+        }
+    }
+
+    colnames(res) = tags;
+    return res;
+}
+
+
 // [[Rcpp::export]]
 NumericMatrix Rinterface(
 	const IntegerVector& 	molecule,
@@ -32,9 +59,9 @@ NumericMatrix Rinterface(
 	int		algo 		= 0,
 	int 	tabSize 	= 1000,
 	int		hashSize 	= 1000,
-	double 	step 		= .25,
 	bool 	showCounts  = false,
-	bool	trim 		= true
+	bool	trim 		= true,
+	int		nThreads	= 1
 ){
 
 	unsigned int dimNumber = molecule.size();
@@ -62,58 +89,61 @@ NumericMatrix Rinterface(
 				if( showCounts )
 					stdIsotopeTags.push_back( isotope[j] );
 			}
+		if( counter == 0 )
+			Rcpp::stop("No isotopes given for one of the elements");
 		stdIsotopeNumbers.push_back(counter);
 	}
 
-	IsoSpec* iso = reinterpret_cast<IsoSpec*>(setupIso(
-		dimNumber,
-		stdIsotopeNumbers.data(),
-		Rcpp::as<std::vector<int> >( molecule).data(),
-		stdIsotopeMasses.data(),
-		stdIsotopeProbabilities.data(),
-		stopCondition,
-		algo,
-		tabSize,
-		hashSize,
-		step,
-        trim
-	));
-
-	int confsNo = iso->getNoVisitedConfs();
-	int columnsNo = stdIsotopeTags.size(); // standard
-
-	int isotopesNo = 0;
-	for( std::vector<int>::iterator it=stdIsotopeNumbers.begin(); it != stdIsotopeNumbers.end(); it++ ){
-		isotopesNo += *it;
+	std::vector<const double*> IM;
+	std::vector<const double*> IP;
+	int idx = 0;
+	for (unsigned int i=0; i<dimNumber; i++)
+	{
+		IM.push_back( &stdIsotopeMasses[idx] );
+		IP.push_back( &stdIsotopeProbabilities[idx] );
+		idx += stdIsotopeNumbers[i];
 	}
 
-	NumericMatrix res(confsNo, columnsNo);
-
-	int i = 0;
-	int j = 0;
+	Iso iso(
+		dimNumber,
+		stdIsotopeNumbers.data(),
+		Rcpp::as<std::vector<int> >( molecule ).data(),
+		IM.data(),
+		IP.data()
+	);
+	const int allDim = iso.getAllDim();
 
-	for( std::vector<void*>::iterator it = iso->newaccepted.begin(); it != iso->newaccepted.end(); it++)
+	switch(algo)
 	{
-		int* curr_conf  = getConf(*it);
-		res(i,0) = combinedSum( curr_conf, iso->masses, dimNumber );
-		res(i,1) = getLProb(*it);
-
-		j = 0;
-		for(unsigned int isotopeNumber=0; isotopeNumber < dimNumber; isotopeNumber++)
+		case ALGO_LAYERED:
+		case ALGO_LAYERED_ESTIMATE: // deprecated: layer sizes are always estimated now
 		{
-			int currentConfIndex = curr_conf[isotopeNumber];
-			int locIsoNo = stdIsotopeNumbers[isotopeNumber];
-
-			if( showCounts )
-				for( int k=0; k<locIsoNo; k++)
-					res(i,2+j+k) = (*(iso->marginalConfs[isotopeNumber]))[currentConfIndex][k];
-			j += locIsoNo;
+			IsoLayeredGenerator generator(std::move(iso), -3.0, tabSize, hashSize);
+			LayeredTabulator tabulator(&generator, stopCondition, trim, true, false, true, showCounts);
+			return tabulator_to_matrix(tabulator, allDim, stdIsotopeTags, showCounts);
+		}
+		case ALGO_ORDERED:
+		{
+			IsoOrderedGenerator generator(std::move(iso), tabSize, hashSize);
+			OrderedTabulator tabulator(&generator, stopCondition, true, false, true, showCounts);
+			return tabulator_to_matrix(tabulator, allDim, stdIsotopeTags, showCounts);
+		}
+		case ALGO_THRESHOLD_ABSOLUTE:
+		case ALGO_THRESHOLD_RELATIVE:
+		{
+			const bool absolute = algo == ALGO_THRESHOLD_ABSOLUTE;
+			if( nThreads == 1 )
+			{
+				IsoThresholdGenerator generator(std::move(iso), stopCondition, absolute, tabSize, hashSize);
+				Tabulator<IsoThresholdGenerator> tabulator(&generator, true, false, true, showCounts);
+				return tabulator_to_matrix(tabulator, allDim, stdIsotopeTags, showCounts);
+			}
+			// nThreads < 1: one per processor
+			ThresholdTabulatorMT tabulator(std::move(iso), stopCondition, absolute, std::max(nThreads, 0),
+			                               true, false, true, showCounts, tabSize, hashSize);
+			return tabulator_to_matrix(tabulator, allDim, stdIsotopeTags, showCounts);
 		}
-		i++;
+		default:
+			Rcpp::stop("Unsupported algo");
 	}
-
-	colnames(res) = stdIsotopeTags; //This is RCPP sugar. It sucks.
-	destroyIso(iso);
-
-	return(res);
 }
@@ -1,29 +0,0 @@
-/*
- *   Copyright (C) 2015-2016 Mateusz Łącki and Michał Startek.
- *
- *   This file is part of IsoSpec.
- *
- *   IsoSpec is free software: you can redistribute it and/or modify
- *   it under the terms of the Simplified ("2-clause") BSD licence.
- *
- *   IsoSpec is distributed in the hope that it will be useful,
- *   but WITHOUT ANY WARRANTY; without even the implied warranty of
- *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  
- *
- *   You should have received a copy of the Simplified BSD Licence
- *   along with IsoSpec.  If not, see <https://opensource.org/licenses/BSD-2-Clause>.
- */
-
-
-#ifndef ISOMATH_HPP
-#define ISOMATH_HPP
-
-double logFactorial(int n);
-double NormalCDFInverse(double p);
-double NormalCDFInverse(double p, double mean, double stdev);
-double NormalCDF(double x, double mean, double stdev);
-double NormalPDF(double x, double mean = 0.0, double stdev = 1.0);
-
-
-
-#endif /* ISOMATH_HPP */
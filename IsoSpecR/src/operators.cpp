@@ -1,31 +0,0 @@
-/*
- *   Copyright (C) 2015-2016 Mateusz Łącki and Michał Startek.
- *
- *   This file is part of IsoSpec.
- *
- *   IsoSpec is free software: you can redistribute it and/or modify
- *   it under the terms of the Simplified ("2-clause") BSD licence.
- *
- *   IsoSpec is distributed in the hope that it will be useful,
- *   but WITHOUT ANY WARRANTY; without even the implied warranty of
- *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  
- *
- *   You should have received a copy of the Simplified BSD Licence
- *   along with IsoSpec.  If not, see <https://opensource.org/licenses/BSD-2-Clause>.
- */
-
-
-#include "operators.h"
-
-KeyHasher::KeyHasher(int dim)
-: dim(dim)
-{}
-
-ConfEqual::ConfEqual(int dim)
-: size( dim*sizeof(int) )
-{}
-
-ConfOrderMarginal::ConfOrderMarginal(const double* logProbs, int dim)
-: logProbs(logProbs), dim(dim)
-{}
-
@@ -0,0 +1,72 @@
+#include <iostream>
+#include <stdexcept>
+#include "isoSpec++.h"
+
+
+// The same configurations, with the same masses and probabilities, in the same order
+int compare(Iso&& iso, const char* formula)
+{
+    IsoThresholdGenerator gen(std::move(iso), 1e-8), ref(Iso(formula), 1e-8);
+    if(gen.getDimNumber() != ref.getDimNumber())
+    {
+        std::cout << formula << ": wrong dimension" << std::endl;
+        return 1;
+    }
+
+    int cnt = 0;
+    while(ref.advanceToNextConfiguration())
+    {
+        if(not gen.advanceToNextConfiguration() or gen.mass() != ref.mass() or gen.lprob() != ref.lprob())
+        {
+            std::cout << formula << ": configuration " << cnt << " differs" << std::endl;
+            return 1;
+        }
+        cnt++;
+    }
+    if(gen.advanceToNextConfiguration())
+    {
+        std::cout << formula << ": too many configurations" << std::endl;
+        return 1;
+    }
+
+    std::cout << formula << ": " << cnt << " configuration(s) OK" << std::endl;
+    return 0;
+}
+
+int main()
+{
+    int failures = 0;
+
+    {
+        const int atomicNumbers[] = {6, 1, 8, 16};
+        const int atomCounts[] = {100, 202, 30, 2};
+        failures += compare(Iso(4, atomicNumbers, atomCounts), "C100H202O30S2");
+    }
+    {
+        // Repeated elements are merged, as in a formula
+        const int atomicNumbers[] = {6, 1, 6};
+        const int atomCounts[] = {2, 6, 3};
+        failures += compare(Iso(3, atomicNumbers, atomCounts), "C5H6");
+    }
+    {
+        const int atomicNumbers[] = {1, 92};
+        const int atomCounts[] = {1, 1};
+        failures += compare(Iso(2, atomicNumbers, atomCounts), "HU");
+    }
+
+    const int unknown[] = {0, -1, 119, 43};     // technetium has no stable isotopes
+    for(int atomicNumber : unknown)
+    {
+        const int atomicNumbers[] = {6, atomicNumber};
+        const int atomCounts[] = {1, 1};
+        try
+        {
+            Iso iso(2, atomicNumbers, atomCounts);
+            std::cout << "Atomic number " << atomicNumber << " accepted" << std::endl;
+            failures++;
+        }
+        catch(std::invalid_argument&) {}
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <string.h>
+#include <stdexcept>
+#include "isoSpec++.h"
+#include "tabulator.h"
+
+
+// Rows offsets()[ii] to offsets()[ii+1] (and confs from conf_offsets()[ii]) have
+// to be exactly what a single-molecule tabulator gets for molecule ii
+int compare(BatchThresholdTabulator& batch, std::vector<Iso>& isos, double threshold, bool absolute, const char* name)
+{
+    if(batch.molecules_no() != isos.size() or batch.offsets()[0] != 0 or batch.conf_offsets()[0] != 0)
+    {
+        std::cout << name << ": wrong number of molecules or offsets" << std::endl;
+        return 1;
+    }
+
+    for(size_t ii=0; ii<isos.size(); ii++)
+    {
+        IsoThresholdGenerator gen(std::move(isos[ii]), threshold, absolute);
+        Tabulator<IsoThresholdGenerator> tab(&gen, true, true, true, true);
+        const size_t start = batch.offsets()[ii];
+        const size_t n = tab.confs_no();
+        const size_t allDim = gen.getAllDim();
+
+        if(batch.offsets()[ii+1] - start != n or batch.conf_offsets()[ii+1] - batch.conf_offsets()[ii] != n*allDim or
+           memcmp(batch.masses() + start, tab.masses(), n*sizeof(double)) != 0 or
+           memcmp(batch.lprobs() + start, tab.lprobs(), n*sizeof(double)) != 0 or
+           memcmp(batch.probs() + start, tab.probs(), n*sizeof(double)) != 0 or
+           memcmp(batch.confs() + batch.conf_offsets()[ii], tab.confs(), n*allDim*sizeof(int)) != 0)
+        {
+            std::cout << name << ": molecule " << ii << " differs" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << name << ": " << batch.molecules_no() << " molecule(s), " << batch.confs_no() << " configuration(s) OK" << std::endl;
+    return 0;
+}
+
+
+int main()
+{
+    int failures = 0;
+
+    // More molecules than fit in a block, of different sizes and with different
+    // numbers of elements (and so of isotopes per conf)
+    std::vector<std::string> formulas;
+    for(int ii=0; ii<3*BATCH_BLOCK_SIZE+5; ii++)
+        switch(ii % 3)
+        {
+            case 0: formulas.push_back("C" + std::to_string(ii+1) + "H" + std::to_string(2*ii+2)); break;
+            case 1: formulas.push_back("C" + std::to_string(ii) + "H" + std::to_string(ii) + "N2O" + std::to_string(ii % 7 + 1) + "S"); break;
+            case 2: formulas.push_back("H2O"); break;
+        }
+    std::vector<const char*> formula_ptrs;
+    for(const std::string& f : formulas)
+        formula_ptrs.push_back(f.c_str());
+
+    for(unsigned int threads : {1u, 4u})
+        for(bool absolute : {true, false})
+        {
+            BatchThresholdTabulator batch(formula_ptrs.data(), formulas.size(), absolute ? 1e-5 : 1e-3, absolute,
+                                          threads, true, true, true, true);
+            std::vector<Iso> isos;
+            for(const std::string& f : formulas)
+                isos.emplace_back(f.c_str());
+            const std::string name = std::string("Formulas, ") + std::to_string(threads) + " thread(s), " + (absolute ? "absolute" : "relative");
+            failures += compare(batch, isos, absolute ? 1e-5 : 1e-3, absolute, name.c_str());
+        }
+
+    // Rows of atom counts over shared isotope data; zero counts included
+    {
+        const int isotopeNumbers[] = {2, 2};
+        const double C_masses[] = {12.0, 13.0033548378};
+        const double C_probs[] = {0.9893, 0.0107};
+        const double H_masses[] = {1.00782503207, 2.0141017778};
+        const double H_probs[] = {0.99985, 0.00015};
+        const double* masses[] = {C_masses, H_masses};
+        const double* probs[] = {C_probs, H_probs};
+
+        const size_t molecules_no = 2*BATCH_BLOCK_SIZE+1;
+        std::vector<int> atomCounts;
+        for(size_t ii=0; ii<molecules_no; ii++)
+        {
+            atomCounts.push_back(ii % 5 == 0 ? 0 : ii);
+            atomCounts.push_back(2*ii+2);
+        }
+
+        BatchThresholdTabulator batch(molecules_no, 2, isotopeNumbers, atomCounts.data(), masses, probs,
+                                      1e-6, true, 3, true, true, true, true);
+        std::vector<Iso> isos;
+        for(size_t ii=0; ii<molecules_no; ii++)
+            isos.emplace_back(2, isotopeNumbers, &atomCounts[2*ii], masses, probs);
+        failures += compare(batch, isos, 1e-6, true, "Counts, 3 thread(s)");
+    }
+
+    // Any bad formula fails the whole batch
+    {
+        formula_ptrs[BATCH_BLOCK_SIZE+1] = "C6H(12";
+        try
+        {
+            BatchThresholdTabulator batch(formula_ptrs.data(), formula_ptrs.size(), 1e-5, true, 4, true, true, true, true);
+            std::cout << "Bad formula accepted" << std::endl;
+            failures++;
+        }
+        catch(std::invalid_argument&) {}
+    }
+
+    return failures == 0 ? 0 : 1;
+}
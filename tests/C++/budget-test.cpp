@@ -0,0 +1,113 @@
+#include <iostream>
+#include <vector>
+#include "isoSpec++.h"
+#include "arena.h"
+
+
+const char* formula = "C520H817N139O147S8";
+int failures = 0;
+
+void check(bool condition, const char* what)
+{
+    if(not condition)
+    {
+        std::cout << "Failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+// Configurations (as log-probabilities) of the generator, at most limit of them
+template<typename T> std::vector<double> enumerate(T& gen, size_t limit)
+{
+    std::vector<double> ret;
+    while(ret.size() < limit and gen.advanceToNextConfiguration())
+        ret.push_back(gen.lprob());
+    return ret;
+}
+
+// A generator whose budget runs out while enumerating has to stop (as if there were
+// no more configurations) after giving a prefix of what an unlimited one gives,
+// and give everything back to the budget once destroyed
+template<typename T> void run_out(const char* name)
+{
+    const size_t wanted = 200000;
+    size_t start_peak, peak;
+    std::vector<double> ref;
+    {
+        T gen{Iso(formula)};
+        start_peak = gen.memory_peak();
+        ref = enumerate(gen, wanted);
+        peak = gen.memory_peak();
+    }
+    check(ref.size() == wanted and peak > start_peak, name);
+
+    // Enough to construct the generator, not to get all the configurations
+    MemoryBudget budget((start_peak + peak) / 2);
+    std::vector<double> got;
+    {
+        T gen{Iso(formula, &budget)};
+        got = enumerate(gen, wanted);
+        check(not gen.advanceToNextConfiguration(), "a generator out of budget stays stopped");
+    }
+    check(budget.exceeded(), "budget reported as exceeded");
+    check(got.size() > 0 and got.size() < wanted, "generator stopped early");
+    check(std::vector<double>(ref.begin(), ref.begin() + got.size()) == got, "configurations before the stop");
+    check(budget.get_used() == 0, "everything given back to the budget");
+
+    std::cout << name << ": stopped after " << got.size() << " of " << wanted << " configuration(s)" << std::endl;
+}
+
+int main()
+{
+    // Too little for the Iso itself
+    {
+        MemoryBudget budget(256);
+        try
+        {
+            Iso iso(formula, &budget);
+            check(false, "Iso constructed over budget");
+        }
+        catch(MemoryBudgetExceeded&) {}
+        check(budget.exceeded() and budget.get_used() == 0, "Iso constructor gives back what it took");
+    }
+
+    // The threshold generator allocates up front: its constructor throws
+    {
+        size_t iso_peak;
+        {
+            Iso iso(formula);
+            iso_peak = iso.memory_peak();
+        }
+        MemoryBudget budget(iso_peak + 1024);
+        try
+        {
+            IsoThresholdGenerator gen(Iso(formula, &budget), 1e-12);
+            check(false, "threshold generator constructed over budget");
+        }
+        catch(MemoryBudgetExceeded&) {}
+        check(budget.exceeded() and budget.get_used() == 0, "threshold generator constructor gives back what it took");
+    }
+
+    run_out<IsoOrderedGenerator>("Ordered");
+    run_out<IsoLayeredGenerator>("Layered");
+
+    // A budget that is enough changes nothing
+    {
+        MemoryBudget budget(1024*1024*1024);
+        std::vector<double> ref, got;
+        {
+            IsoThresholdGenerator gen(Iso(formula), 1e-8);
+            ref = enumerate(gen, static_cast<size_t>(-1));
+        }
+        {
+            IsoThresholdGenerator gen(Iso(formula, &budget), 1e-8);
+            got = enumerate(gen, static_cast<size_t>(-1));
+            check(budget.get_used() > 0, "allocations go through the budget");
+        }
+        check(ref == got and not budget.exceeded() and budget.get_used() == 0, "enumeration within budget");
+    }
+
+    std::cout << failures << " failure(s)" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
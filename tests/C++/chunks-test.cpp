@@ -0,0 +1,238 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "isoSpec++.h"
+#include "cwrapper.h"
+
+#define FORMULA "C10H20O5S"
+
+// A generator set up through the C API, with the marginals it needs (if any)
+struct Handle
+{
+    void* generator;
+    void* marginals;
+};
+
+struct API
+{
+    const char* name;
+    Handle (*setup)();
+    void (*destroy)(void*);
+    bool (*advance)(void*);
+    double (*mass)(void*);
+    double (*lprob)(void*);
+    void (*signature)(void*, int*);
+    int (*next_chunk)(void*, int, double*, double*, double*, int*);
+    long long (*stream_chunks)(void*, int, double*, double*, double*, int*, chunk_callback, void*);
+};
+
+Handle threshold()
+{
+    Iso iso(FORMULA);
+    return Handle{setupIsoThresholdGenerator(&iso, 1e-6, true, 1000, 1000), nullptr};
+}
+
+Handle layered()
+{
+    Iso iso(FORMULA);
+    return Handle{setupIsoLayeredGenerator(&iso, -3.0, 1000, 1000), nullptr};
+}
+
+Handle ordered()
+{
+    Iso iso(FORMULA);
+    return Handle{setupIsoOrderedGenerator(&iso, 1000, 1000), nullptr};
+}
+
+Handle threshold_mt()
+{
+    Iso iso(FORMULA);
+    void* marginals = setupThresholdMTMarginals(&iso, 1e-6, true, 1000, 1000);
+    return Handle{setupIsoThresholdGeneratorMT(marginals), marginals};
+}
+
+#define GENERATOR_API(name, setup, generatorType) \
+    API{name, setup, delete##generatorType, advanceToNextConfiguration##generatorType, mass##generatorType, \
+        lprob##generatorType, get_conf_signature##generatorType, nextChunk##generatorType, streamChunks##generatorType}
+
+const API apis[] = {
+    GENERATOR_API("Threshold", threshold, IsoThresholdGenerator),
+    GENERATOR_API("Layered", layered, IsoLayeredGenerator),
+    GENERATOR_API("Ordered", ordered, IsoOrderedGenerator),
+    GENERATOR_API("ThresholdMT", threshold_mt, IsoThresholdGeneratorMT)
+};
+
+void release(const API& api, Handle handle)
+{
+    api.destroy(handle.generator);
+    if(handle.marginals != nullptr)
+        deleteThresholdMTMarginals(handle.marginals);
+}
+
+struct Columns
+{
+    std::vector<double> masses, probs, lprobs;
+    std::vector<int> confs;
+};
+
+// The configurations read one by one
+Columns one_by_one(const API& api, int allDim)
+{
+    Columns ret;
+    Handle handle = api.setup();
+    std::vector<int> conf(allDim);
+    while(api.advance(handle.generator))
+    {
+        ret.masses.push_back(api.mass(handle.generator));
+        ret.lprobs.push_back(api.lprob(handle.generator));
+        api.signature(handle.generator, conf.data());
+        ret.confs.insert(ret.confs.end(), conf.begin(), conf.end());
+    }
+    release(api, handle);
+    return ret;
+}
+
+// Chunk buffers, appended to columns after each chunk
+struct Buffers
+{
+    std::vector<double> masses, probs, lprobs;
+    std::vector<int> confs;
+    int allDim;
+    Columns out;
+    int chunks;
+    int stop_after;
+
+    Buffers(int max_rows, int _allDim, int _stop_after = -1) :
+    masses(max_rows), probs(max_rows), lprobs(max_rows), confs(static_cast<size_t>(max_rows)*_allDim),
+    allDim(_allDim), chunks(0), stop_after(_stop_after) {}
+
+    void append(int rows)
+    {
+        out.masses.insert(out.masses.end(), masses.begin(), masses.begin() + rows);
+        out.probs.insert(out.probs.end(), probs.begin(), probs.begin() + rows);
+        out.lprobs.insert(out.lprobs.end(), lprobs.begin(), lprobs.begin() + rows);
+        out.confs.insert(out.confs.end(), confs.begin(), confs.begin() + static_cast<size_t>(rows)*allDim);
+        chunks++;
+    }
+};
+
+bool append_chunk(void* user_data, int rows)
+{
+    Buffers* buffers = reinterpret_cast<Buffers*>(user_data);
+    buffers->append(rows);
+    return buffers->chunks != buffers->stop_after;
+}
+
+bool same_as(const Columns& got, const Columns& expected, size_t rows, int allDim)
+{
+    if(got.masses.size() != rows or got.confs.size() != rows*allDim)
+        return false;
+    for(size_t ii = 0; ii < rows; ii++)
+        if(got.masses[ii] != expected.masses[ii] or got.lprobs[ii] != expected.lprobs[ii] or
+           std::abs(got.probs[ii] - exp(got.lprobs[ii])) > 1e-12 * got.probs[ii])
+            return false;
+    return std::equal(got.confs.begin(), got.confs.end(), expected.confs.begin());
+}
+
+int test(const API& api)
+{
+    const int allDim = Iso(FORMULA).getAllDim();
+    const Columns expected = one_by_one(api, allDim);
+    const int total = static_cast<int>(expected.masses.size());
+    int failures = 0;
+
+    const int sizes[] = {1, 7, total - 1, total, total + 1};
+    for(int max_rows : sizes)
+    {
+        // nextChunk until it returns less than max_rows
+        {
+            Buffers buffers(max_rows, allDim);
+            Handle handle = api.setup();
+            int rows;
+            do
+            {
+                rows = api.next_chunk(handle.generator, max_rows, buffers.masses.data(), buffers.probs.data(),
+                                      buffers.lprobs.data(), buffers.confs.data());
+                buffers.append(rows);
+            }
+            while(rows == max_rows);
+            release(api, handle);
+
+            if(not same_as(buffers.out, expected, total, allDim))
+            {
+                std::cout << api.name << ": nextChunk(" << max_rows << ") differs" << std::endl;
+                failures++;
+            }
+        }
+
+        // streamChunks to the end
+        {
+            Buffers buffers(max_rows, allDim);
+            Handle handle = api.setup();
+            const long long streamed = api.stream_chunks(handle.generator, max_rows, buffers.masses.data(),
+                                                         buffers.probs.data(), buffers.lprobs.data(),
+                                                         buffers.confs.data(), append_chunk, &buffers);
+            release(api, handle);
+
+            if(streamed != total or buffers.chunks != (total + max_rows - 1) / max_rows or
+               not same_as(buffers.out, expected, total, allDim))
+            {
+                std::cout << api.name << ": streamChunks(" << max_rows << ") differs" << std::endl;
+                failures++;
+            }
+        }
+    }
+
+    // Stopped by the callback after two chunks, which are all that was read
+    {
+        const int max_rows = 7;
+        Buffers buffers(max_rows, allDim, 2);
+        Handle handle = api.setup();
+        const long long streamed = api.stream_chunks(handle.generator, max_rows, buffers.masses.data(),
+                                                     buffers.probs.data(), buffers.lprobs.data(),
+                                                     buffers.confs.data(), append_chunk, &buffers);
+        release(api, handle);
+
+        if(streamed != 2 * max_rows or buffers.chunks != 2 or not same_as(buffers.out, expected, 2 * max_rows, allDim))
+        {
+            std::cout << api.name << ": streamChunks not stopped by the callback" << std::endl;
+            failures++;
+        }
+    }
+
+    // Columns left out as null pointers
+    {
+        const int max_rows = 7;
+        std::vector<double> lprobs(max_rows);
+        std::vector<double> got;
+        Handle handle = api.setup();
+        int rows;
+        do
+        {
+            rows = api.next_chunk(handle.generator, max_rows, nullptr, nullptr, lprobs.data(), nullptr);
+            got.insert(got.end(), lprobs.begin(), lprobs.begin() + rows);
+        }
+        while(rows == max_rows);
+        release(api, handle);
+
+        if(got != expected.lprobs)
+        {
+            std::cout << api.name << ": nextChunk with null columns differs" << std::endl;
+            failures++;
+        }
+    }
+
+    if(failures == 0)
+        std::cout << api.name << ": " << total << " configuration(s) OK" << std::endl;
+    return failures;
+}
+
+int main()
+{
+    int failures = 0;
+    for(const API& api : apis)
+        failures += test(api);
+
+    return failures == 0 ? 0 : 1;
+}
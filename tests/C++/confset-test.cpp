@@ -0,0 +1,123 @@
+#include <iostream>
+#include <vector>
+#include <set>
+#include <random>
+#include "confSet.h"
+#include "arena.h"
+
+
+int failures = 0;
+
+void check(bool condition, const char* what)
+{
+    if(not condition)
+    {
+        std::cout << "Failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+// Every configuration in the reference set, and none of the others in the range
+bool same_contents(const ConfSet& s, const std::set<std::vector<int> >& ref, int dim, int range)
+{
+    if(s.size() != ref.size())
+        return false;
+    std::vector<int> conf(dim, 0);
+    while(true)
+    {
+        if(s.contains(conf.data()) != (ref.count(conf) > 0))
+            return false;
+        int ii = 0;
+        while(ii < dim and ++conf[ii] == range)
+            conf[ii++] = 0;
+        if(ii == dim)
+            return true;
+    }
+}
+
+// Random inserts and erases against std::set: small ranges give many repeats,
+// and erasing and inserting again goes through deleted slots
+void random_ops(int dim, int range, size_t ops, size_t initial_slots)
+{
+    std::mt19937 rng(dim * 1000 + range);
+    std::uniform_int_distribution<int> value(0, range-1);
+    std::uniform_int_distribution<int> op(0, 2);
+
+    ConfSet s(dim, initial_slots);
+    std::set<std::vector<int> > ref;
+    std::vector<int> conf(dim);
+
+    for(size_t ii=0; ii<ops; ii++)
+    {
+        for(int& c : conf)
+            c = value(rng);
+        if(op(rng) < 2)
+            check(s.insert(conf.data()) == ref.insert(conf).second, "insert");
+        else
+            check(s.erase(conf.data()) == (ref.erase(conf) > 0), "erase");
+        if(failures > 0)
+            return;
+    }
+    check(same_contents(s, ref, dim, range), "contents after random operations");
+
+    // Empty it, and fill it up again
+    for(const std::vector<int>& c : ref)
+        check(s.erase(c.data()), "erase everything");
+    check(s.size() == 0 and same_contents(s, std::set<std::vector<int> >(), dim, range), "empty set");
+    for(const std::vector<int>& c : ref)
+        check(s.insert(c.data()), "insert again");
+    check(same_contents(s, ref, dim, range), "contents after reinserting");
+
+    std::cout << "dim " << dim << ", range " << range << ": " << ref.size() << " configuration(s) OK" << std::endl;
+}
+
+int main()
+{
+    random_ops(1, 5000, 20000, 1);
+    random_ops(3, 12, 20000, 16);
+    random_ops(5, 6, 50000, 1000);
+
+    // Negative and large counts hash like any others
+    {
+        ConfSet s(2);
+        const int a[] = {-1, 0}, b[] = {0, -1}, c[] = {2147483647, -2147483647-1};
+        check(s.insert(a) and s.insert(b) and s.insert(c) and not s.insert(a), "unusual counts");
+        check(s.contains(a) and s.contains(b) and s.contains(c) and s.size() == 3, "unusual counts looked up");
+    }
+
+    // Growth that runs out of memory leaves the set as it was
+    {
+        MemoryBudget budget(8*1024);
+        ConfSet s(4, 16, &budget);
+        std::set<std::vector<int> > ref;
+        std::vector<int> conf(4, 0);
+        bool stopped = false;
+        for(int ii=0; ii<100000 and not stopped; ii++)
+        {
+            conf[0] = ii;
+            try
+            {
+                s.insert(conf.data());
+                ref.insert(conf);
+            }
+            catch(MemoryBudgetExceeded&)
+            {
+                stopped = true;
+            }
+        }
+        check(stopped, "budget reached");
+        check(s.size() == ref.size(), "size after failed growth");
+        for(const std::vector<int>& c : ref)
+            if(not s.contains(c.data()))
+            {
+                check(false, "contents after failed growth");
+                break;
+            }
+        conf[0] = 0;
+        check(s.erase(conf.data()) and s.insert(conf.data()), "set usable after failed growth");
+    }
+
+    std::cout << failures << " failure(s)" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+#include <iostream>
+#include <vector>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include "isoSpec++.h"
+#include "tabulator.h"
+#include "arrowWriter.h"
+
+
+// What a Tabulator gets out of a fresh generator, to compare the files against
+struct Expected
+{
+    std::vector<double> masses, lprobs, probs;
+    std::vector<int> confs;
+    int allDim;
+
+    Expected(const char* formula, double threshold, size_t skip)
+    {
+        IsoThresholdGenerator gen(Iso(formula), threshold);
+        for(size_t ii=0; ii<skip; ii++)
+            gen.advanceToNextConfiguration();
+        Tabulator<IsoThresholdGenerator> tab(&gen, true, true, true, true);
+        allDim = gen.getAllDim();
+        masses.assign(tab.masses(), tab.masses() + tab.confs_no());
+        lprobs.assign(tab.lprobs(), tab.lprobs() + tab.confs_no());
+        probs.assign(tab.probs(), tab.probs() + tab.confs_no());
+        confs.assign(tab.confs(), tab.confs() + tab.confs_no()*allDim);
+    }
+};
+
+std::vector<uint8_t> read_file(const char* path)
+{
+    std::vector<uint8_t> ret;
+    FILE* f = fopen(path, "rb");
+    if(f == nullptr)
+        return ret;
+    uint8_t buf[4096];
+    size_t n;
+    while((n = fread(buf, 1, sizeof(buf), f)) > 0)
+        ret.insert(ret.end(), buf, buf+n);
+    fclose(f);
+    return ret;
+}
+
+template<typename V> V get(const std::vector<uint8_t>& data, size_t pos)
+{
+    V ret;
+    memcpy(&ret, &data[pos], sizeof(V));
+    return ret;
+}
+
+
+int test_file(const char* formula, size_t skip)
+{
+    const char* path = "file-output-test.isospec";
+    Expected exp(formula, 1e-6, skip);
+
+    {
+        IsoThresholdGenerator gen(Iso(formula), 1e-6);
+        for(size_t ii=0; ii<skip; ii++)
+            gen.advanceToNextConfiguration();
+        FileTabulator<IsoThresholdGenerator> tab(&gen, path, true, true, true, true);
+    }
+
+    std::vector<uint8_t> data = read_file(path);
+    remove(path);
+
+    TabulatorFileHeader h;
+    if(data.size() < sizeof(h))
+        return 1;
+    memcpy(&h, data.data(), sizeof(h));
+    const size_t n = exp.masses.size();
+    if(memcmp(h.magic, TABULATOR_FILE_MAGIC, 8) != 0 or h.version != TABULATOR_FILE_VERSION or
+       h.confs_dim != static_cast<uint32_t>(exp.allDim) or h.confs_no != n)
+        return 1;
+    for(int ii=0; ii<4; ii++)
+        if(h.offsets[ii] % 64 != 0)
+            return 1;
+    if(data.size() < h.offsets[3] + n*exp.allDim*sizeof(int))
+        return 1;
+
+    if(n > 0 and (memcmp(&data[h.offsets[0]], exp.masses.data(), n*sizeof(double)) != 0 or
+       memcmp(&data[h.offsets[1]], exp.lprobs.data(), n*sizeof(double)) != 0 or
+       memcmp(&data[h.offsets[2]], exp.probs.data(), n*sizeof(double)) != 0 or
+       memcmp(&data[h.offsets[3]], exp.confs.data(), n*exp.allDim*sizeof(int)) != 0))
+        return 1;
+
+    std::cout << "File, " << formula << " skipping " << skip << ": " << n << " configuration(s) OK" << std::endl;
+    return 0;
+}
+
+
+// Just enough of a flatbuffer reader to walk Arrow messages: position of the
+// id-th field of the table at pos, or 0 if it is absent
+size_t fb_field(const std::vector<uint8_t>& data, size_t table, int id)
+{
+    const size_t vtable = table - get<int32_t>(data, table);
+    if(4 + 2*id >= get<uint16_t>(data, vtable))
+        return 0;
+    const uint16_t off = get<uint16_t>(data, vtable + 4 + 2*id);
+    return off == 0 ? 0 : table + off;
+}
+
+size_t fb_deref(const std::vector<uint8_t>& data, size_t pos)
+{
+    return pos + get<uint32_t>(data, pos);
+}
+
+int test_arrow(const char* formula, bool file_format, size_t batch_size)
+{
+    const char* path = "file-output-test.arrow";
+    Expected exp(formula, 1e-6, 0);
+
+    {
+        IsoThresholdGenerator gen(Iso(formula), 1e-6);
+        ArrowTabulator<IsoThresholdGenerator> tab(&gen, path, file_format, true, true, true, true, batch_size);
+        if(tab.confs_no() != exp.masses.size())
+            return 1;
+    }
+
+    std::vector<uint8_t> data = read_file(path);
+    remove(path);
+
+    size_t pos = 0;
+    if(file_format)
+    {
+        if(data.size() < 16 or memcmp(data.data(), "ARROW1", 6) != 0 or memcmp(&data[data.size()-6], "ARROW1", 6) != 0)
+            return 1;
+        pos = 8;
+    }
+
+    // Schema, then the batches (masses, probs, lprobs, confs), then end of stream
+    size_t row = 0;
+    int batches = 0;
+    bool schema = false;
+    while(true)
+    {
+        if(pos + 8 > data.size() or get<uint32_t>(data, pos) != 0xFFFFFFFF)
+            return 1;
+        const int32_t length = get<int32_t>(data, pos+4);
+        pos += 8;
+        if(length == 0)
+            break;
+
+        const size_t message = fb_deref(data, pos);
+        const uint8_t header_type = get<uint8_t>(data, fb_field(data, message, 1));
+        const size_t header = fb_deref(data, fb_field(data, message, 2));
+        const int64_t body_length = fb_field(data, message, 3) == 0 ? 0 : get<int64_t>(data, fb_field(data, message, 3));
+        const size_t body = pos + length;
+
+        if(header_type == 1)
+        {
+            const size_t fields = fb_deref(data, fb_field(data, header, 1));
+            if(get<uint32_t>(data, fields) != 4)
+                return 1;
+            schema = true;
+        }
+        else if(header_type == 3 and schema)
+        {
+            const int64_t rows = get<int64_t>(data, fb_field(data, header, 0));
+            if(rows <= 0 or static_cast<size_t>(rows) > batch_size or row + rows > exp.masses.size())
+                return 1;
+
+            // Validity and values buffers of each double column, then validity of
+            // the list, validity and values of its items
+            const size_t buffers = fb_deref(data, fb_field(data, header, 2));
+            if(get<uint32_t>(data, buffers) != 9)
+                return 1;
+            const std::vector<double>* doubles[3] = {&exp.masses, &exp.probs, &exp.lprobs};
+            for(int ii=0; ii<3; ii++)
+            {
+                const size_t buf = buffers + 4 + 16*(2*ii+1);
+                if(get<int64_t>(data, buf+8) != rows*8 or
+                   memcmp(&data[body + get<int64_t>(data, buf)], doubles[ii]->data() + row, rows*8) != 0)
+                    return 1;
+            }
+            const size_t buf = buffers + 4 + 16*8;
+            if(get<int64_t>(data, buf+8) != rows*exp.allDim*4 or
+               memcmp(&data[body + get<int64_t>(data, buf)], exp.confs.data() + row*exp.allDim, rows*exp.allDim*4) != 0)
+                return 1;
+
+            row += rows;
+            batches++;
+        }
+        else
+            return 1;
+
+        pos = body + body_length;
+    }
+
+    if(row != exp.masses.size() or batches != static_cast<int>((row + batch_size - 1) / batch_size))
+        return 1;
+
+    std::cout << "Arrow " << (file_format ? "file" : "stream") << ", " << formula << " in batches of " << batch_size
+              << ": " << row << " configuration(s) OK" << std::endl;
+    return 0;
+}
+
+
+int main()
+{
+    int failures = 0;
+
+    failures += test_file("C100H202O30S2", 0);
+    // The size hint must not rewind a partly consumed generator
+    failures += test_file("C100H202O30S2", 5);
+    failures += test_file("H2O", 1000);
+
+    failures += test_arrow("C100H202O30S2", false, 7);
+    failures += test_arrow("C100H202O30S2", true, 7);
+    failures += test_arrow("C100H202O30S2", true, ARROW_DEFAULT_BATCH_SIZE);
+
+    std::cout << failures << " failure(s)" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
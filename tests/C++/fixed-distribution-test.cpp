@@ -0,0 +1,95 @@
+#include <iostream>
+#include <map>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include "isoSpec++.h"
+#include "tabulator.h"
+
+
+// The same configurations as the threshold generator, most probable first
+int compare(const FixedDistribution& fixed, const char* formula, double threshold)
+{
+    std::map<std::vector<int>, std::pair<double, double> > expected;
+    IsoThresholdGenerator ref(Iso(formula), threshold);
+    const int allDim = ref.getAllDim();
+    std::vector<int> conf(allDim);
+    while(ref.advanceToNextConfiguration())
+    {
+        ref.get_conf_signature(conf.data());
+        expected[conf] = std::make_pair(ref.mass(), ref.lprob());
+    }
+
+    if(fixed.getAllDim() != allDim or fixed.confs_no() != expected.size())
+    {
+        std::cout << formula << ": wrong size" << std::endl;
+        return 1;
+    }
+
+    for(size_t ii = 0; ii < fixed.confs_no(); ii++)
+    {
+        conf.assign(fixed.confs() + ii*allDim, fixed.confs() + (ii+1)*allDim);
+        auto it = expected.find(conf);
+        if(it == expected.end() or it->second.first != fixed.masses()[ii] or it->second.second != fixed.lprobs()[ii]
+           or fixed.probs()[ii] != exp(fixed.lprobs()[ii]))
+        {
+            std::cout << formula << ": configuration " << ii << " differs" << std::endl;
+            return 1;
+        }
+        if(ii > 0 and fixed.lprobs()[ii] > fixed.lprobs()[ii-1])
+        {
+            std::cout << formula << ": configuration " << ii << " out of order" << std::endl;
+            return 1;
+        }
+        expected.erase(it);
+    }
+
+    std::cout << formula << ": " << fixed.confs_no() << " configuration(s) OK" << std::endl;
+    return 0;
+}
+
+const FixedDistribution& water()
+{
+    return ISO_FIXED_DISTRIBUTION("H2O", 1e-6);
+}
+
+const FixedDistribution& tryptophan_residue()
+{
+    return ISO_FIXED_DISTRIBUTION("C11H10N2O", 1e-6);
+}
+
+const FixedDistribution& from_variable(const char* formula)
+{
+    return ISO_FIXED_DISTRIBUTION(formula, 1e-6);
+}
+
+int main()
+{
+    int failures = 0;
+
+    failures += compare(FixedDistribution("H2O", 1e-6), "H2O", 1e-6);
+    failures += compare(FixedDistribution("C11H10N2O", 1e-6), "C11H10N2O", 1e-6);
+    failures += compare(water(), "H2O", 1e-6);
+    failures += compare(tryptophan_residue(), "C11H10N2O", 1e-6);
+
+    if(&water() != &water())
+    {
+        std::cout << "H2O: the table is rebuilt" << std::endl;
+        failures++;
+    }
+
+    // A use site fed other arguments than the first time must not hand back the first table
+    failures += compare(from_variable("C6H12O6"), "C6H12O6", 1e-6);
+    try
+    {
+        from_variable("H2O");
+        std::cout << "ISO_FIXED_DISTRIBUTION: different formula accepted" << std::endl;
+        failures++;
+    }
+    catch(const std::logic_error&)
+    {
+        std::cout << "ISO_FIXED_DISTRIBUTION: different formula rejected OK" << std::endl;
+    }
+
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,77 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include "isoSpec++.h"
+#include "element_tables.h"
+
+
+// The formula as parsed, with every count spelled out: "C3H6" for "(CH2)3"
+std::string parsed(const char* formula)
+{
+    std::vector<const double*> masses, probs;
+    int* isotopeNumbers;
+    int* atomCounts;
+    unsigned int confSize;
+    unsigned int dimNumber = parse_formula(formula, masses, probs, &isotopeNumbers, &atomCounts, &confSize);
+
+    std::string ret;
+    for(unsigned int ii=0; ii<dimNumber; ii++)
+        ret += elem_table_symbol[masses[ii] - elem_table_mass] + std::to_string(atomCounts[ii]);
+
+    resource_delete(default_memory_resource(), isotopeNumbers, dimNumber);
+    resource_delete(default_memory_resource(), atomCounts, dimNumber);
+    return ret;
+}
+
+int main()
+{
+    const char* valid[][2] = {
+        {"C3H6", "C3H6"},
+        {"H2O", "H2O1"},
+        {"Co", "Co1"},
+        {"CO", "C1O1"},
+        {"(CH2)3", "C3H6"},
+        {"CH3(CH2)2CH3", "C4H10"},
+        {"Ca(OH)2", "Ca1O2H2"},
+        {"((CH2)2O)3H2", "C6H14O3"},
+        {" C6 H12\tO6 ", "C6H12O6"},
+    };
+
+    const char* invalid[] = {"", "  ", "c6", "2C", "C2 3", "Xx", "C(H", "CH)", "()", "H2O-"};
+
+    int failures = 0;
+
+    for(auto& t : valid)
+    {
+        std::string got;
+        try
+        {
+            got = parsed(t[0]);
+        }
+        catch(std::invalid_argument&)
+        {
+            got = "invalid";
+        }
+        if(got != t[1])
+        {
+            std::cout << "\"" << t[0] << "\": expected " << t[1] << ", got " << got << std::endl;
+            failures++;
+        }
+    }
+
+    for(const char* formula : invalid)
+    {
+        try
+        {
+            std::string got = parsed(formula);
+            std::cout << "\"" << formula << "\": expected an error, got " << got << std::endl;
+            failures++;
+        }
+        catch(std::invalid_argument&) {}
+    }
+
+    std::cout << failures << " failure(s)" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
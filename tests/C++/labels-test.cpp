@@ -0,0 +1,105 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <string.h>
+#include <stdexcept>
+#include "isoSpec++.h"
+#include "isotopeLabels.h"
+
+
+int failures = 0;
+
+void check(bool condition, const char* what)
+{
+    if(not condition)
+    {
+        std::cout << "Failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+template<typename F> void check_throws(const F& f, const char* what)
+{
+    try
+    {
+        f();
+        std::cout << "Accepted: " << what << std::endl;
+        failures++;
+    }
+    catch(std::invalid_argument&) {}
+}
+
+const double* lookup(int first, const char* label)
+{
+    return labelled_probabilities(first, label, strlen(label));
+}
+
+int dimensions(const char* formula)
+{
+    std::vector<const double*> masses, probs;
+    int* isotopeNumbers;
+    int* atomCounts;
+    unsigned int confSize;
+    unsigned int dimNumber = parse_formula(formula, masses, probs, &isotopeNumbers, &atomCounts, &confSize);
+    resource_delete(default_memory_resource(), isotopeNumbers, dimNumber);
+    resource_delete(default_memory_resource(), atomCounts, dimNumber);
+    return dimNumber;
+}
+
+int main()
+{
+    int C_no, N_no;
+    const int C = find_element("C", 1, &C_no);
+    const int N = find_element("N", 1, &N_no);
+    check(C >= 0 and C_no == 2 and N >= 0 and N_no == 2, "element lookup");
+    check(find_element("Xx", 2, &C_no) < 0, "unknown element");
+    check(find_element_by_atomic_number(6, &C_no) == C, "lookup by atomic number");
+
+    // Specs: isotopes not mentioned share the rest in their natural proportions
+    const double* c13 = lookup(C, "13C=0.99");
+    check(c13[0] > 0.0099999 and c13[0] < 0.0100001 and c13[1] == 0.99, "13C=0.99");
+    check(lookup(C, "13C=0.99") == c13, "the same spec gives the same table");
+    check(lookup(C, "13=0.99") == c13, "equal tables are shared");
+    const double* full = lookup(C, "13C=1");
+    check(full[1] == 1.0 and full[0] > 0.0, "fully labelled elements keep a nonzero abundance");
+
+    // Names: the newest registration wins, and names are per element
+    register_isotope_label("SILAC", "C", "13C=0.99");
+    check(memcmp(lookup(C, "SILAC"), c13, C_no*sizeof(double)) == 0, "registered label");
+    register_isotope_label("SILAC", "C", "13C=0.5");
+    check(lookup(C, "SILAC")[1] == 0.5, "registration replaces the older one");
+    register_isotope_label("SILAC", "N", "15N=0.98");
+    check(lookup(N, "SILAC")[1] == 0.98 and lookup(C, "SILAC")[1] == 0.5, "labels are per element");
+
+    check_throws([&]{ lookup(C, "UNKNOWN"); }, "unknown label name");
+    check_throws([&]{ lookup(N, "13C=0.5"); }, "spec for another element");
+    check_throws([&]{ lookup(C, "14C=0.5"); }, "isotope missing from the tables");
+    check_throws([&]{ lookup(C, "13C=1.5"); }, "abundance above 1");
+    check_throws([&]{ lookup(C, "13C=0.6,12C=0.6"); }, "abundances summing up above 1");
+    check_throws([&]{ lookup(C, "13C=0.5,13=0.1"); }, "isotope given twice");
+    check_throws([&]{ lookup(C, "13C"); }, "spec without abundance");
+    check_throws([&]{ lookup(C, "13C=x"); }, "spec with a bad number");
+    check_throws([&]{ register_isotope_label("1abc", "C", "13C=0.5"); }, "name starting with a digit");
+    check_throws([&]{ register_isotope_label("Heavy", "Xx", "13C=0.5"); }, "label of an unknown element");
+
+    // In formulas: rows with the same label are merged, labelled and natural ones are not
+    check(dimensions("C[SILAC]3C[13C=0.5]3H12") == 2, "merging equal labels");
+    check(dimensions("C[SILAC]3C3H12") == 3, "labelled and natural rows kept apart");
+    check_throws([&]{ dimensions("C[UNKNOWN]6"); }, "formula with an unknown label");
+    check_throws([&]{ dimensions("C[SILAC6"); }, "formula with an unterminated label");
+
+    // Tables are registered from several threads at once, and still shared
+    const int threads_no = 8;
+    std::vector<const double*> got(threads_no);
+    std::vector<std::thread> threads;
+    for(int ii=0; ii<threads_no; ii++)
+        threads.emplace_back([&, ii]{ got[ii] = lookup(N, "15N=0.25"); });
+    for(std::thread& t : threads)
+        t.join();
+    for(int ii=1; ii<threads_no; ii++)
+        check(got[ii] == got[0], "tables registered concurrently are shared");
+
+    std::cout << failures << " failure(s)" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
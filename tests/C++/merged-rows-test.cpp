@@ -0,0 +1,126 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "isoSpec++.h"
+
+
+const double H_masses[] = {1.00782503207, 2.0141017778};
+const double H_probs[] = {0.99985, 0.00015};
+const double C_masses[] = {12.0, 13.0033548378};
+const double C_probs[] = {0.9893, 0.0107};
+
+// H and C given twice each: H6 C2 H1 C3, merged into H7 C5
+Iso merged()
+{
+    const int isotopeNumbers[] = {2, 2, 2, 2};
+    const int atomCounts[] = {6, 2, 1, 3};
+    const double* masses[] = {H_masses, C_masses, H_masses, C_masses};
+    const double* probs[] = {H_probs, C_probs, H_probs, C_probs};
+    return Iso(4, isotopeNumbers, atomCounts, masses, probs);
+}
+
+Iso reference()
+{
+    const int isotopeNumbers[] = {2, 2};
+    const int atomCounts[] = {7, 5};
+    const double* masses[] = {H_masses, C_masses};
+    const double* probs[] = {H_probs, C_probs};
+    return Iso(2, isotopeNumbers, atomCounts, masses, probs);
+}
+
+// The layout expected of the merged generator: the atoms of each element split
+// greedily between its two rows, the first one taking up to its own count (6 H,
+// 2 C) starting from the lightest isotope, and the repeated one taking the rest.
+std::vector<int> split(const std::vector<int>& ref_conf)
+{
+    std::vector<int> conf(8);
+    const int first_counts[] = {6, 2};
+    for(int el=0; el<2; el++)
+    {
+        const int light = ref_conf[2*el], heavy = ref_conf[2*el+1];
+        const int first_light = std::min(light, first_counts[el]);
+        const int first_heavy = first_counts[el] - first_light;
+        conf[2*el] = first_light;
+        conf[2*el+1] = first_heavy;
+        conf[4+2*el] = light - first_light;
+        conf[4+2*el+1] = heavy - first_heavy;
+    }
+    return conf;
+}
+
+// Both generators have the same marginals, so they visit the configurations in
+// the same order; the merged one has to lay them out in the rows it was given.
+int compare(IsoGenerator& gen, IsoGenerator& ref, const char* name)
+{
+    if(gen.getDimNumber() != 2 or gen.getAllDim() != 8 or ref.getAllDim() != 4)
+    {
+        std::cout << name << ": rows were not merged" << std::endl;
+        return 1;
+    }
+
+    std::vector<int> conf(8), ref_conf(4);
+    int cnt = 0;
+    while(ref.advanceToNextConfiguration())
+    {
+        if(not gen.advanceToNextConfiguration() or gen.lprob() != ref.lprob())
+        {
+            std::cout << name << ": configuration " << cnt << " differs" << std::endl;
+            return 1;
+        }
+        gen.get_conf_signature(conf.data());
+        ref.get_conf_signature(ref_conf.data());
+        if(conf != split(ref_conf) or conf[0] + conf[1] != 6 or conf[2] + conf[3] != 2
+           or conf[4] + conf[5] != 1 or conf[6] + conf[7] != 3)
+        {
+            std::cout << name << ": wrong layout of configuration " << cnt << std::endl;
+            return 1;
+        }
+        cnt++;
+    }
+
+    if(gen.advanceToNextConfiguration())
+    {
+        std::cout << name << ": too many configurations" << std::endl;
+        return 1;
+    }
+
+    std::cout << name << ": " << cnt << " configuration(s) OK" << std::endl;
+    return 0;
+}
+
+int main()
+{
+    int failures = 0;
+
+    {
+        IsoThresholdGenerator gen(merged(), 1e-12), ref(reference(), 1e-12);
+        failures += compare(gen, ref, "Threshold");
+    }
+    {
+        IsoOrderedGenerator gen(merged()), ref(reference());
+        failures += compare(gen, ref, "Ordered");
+    }
+    {
+        IsoLayeredGenerator gen(merged()), ref(reference());
+        failures += compare(gen, ref, "Layered");
+    }
+    {
+        // The compact form expands to the same layout
+        IsoThresholdGenerator gen(merged(), 1e-12);
+        std::vector<int> indices(2), conf(8), expanded(8);
+        while(gen.advanceToNextConfiguration())
+        {
+            gen.get_conf_signature(conf.data());
+            gen.get_marginal_indices(indices.data());
+            gen.expand_conf(indices.data(), expanded.data());
+            if(conf != expanded)
+            {
+                std::cout << "expand_conf: wrong layout" << std::endl;
+                failures++;
+                break;
+            }
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
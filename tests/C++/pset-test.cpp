@@ -0,0 +1,29 @@
+#include <iostream>
+#include "isoSpec++.h"
+#include "tabulator.h"
+
+
+int main()
+{
+    const double target = 0.99;
+
+    IsoLayeredGenerator* gen = new IsoLayeredGenerator(Iso("C100H202O30S2"), -3.0);
+    LayeredTabulator tab(gen, target, true, true, true, true, false);
+    delete gen;
+
+    // Compare against the optimal p-set obtained by visiting configurations in order
+    IsoOrderedGenerator* ord = new IsoOrderedGenerator(Iso("C100H202O30S2"));
+    Summator s;
+    size_t cnt = 0;
+    while(s.get() < target and ord->advanceToNextConfiguration())
+    {
+        s.add(ord->eprob());
+        cnt++;
+    }
+    delete ord;
+
+    std::cout << "Layered p-set: " << tab.confs_no() << " configuration(s), prob: " << tab.total_prob() << std::endl;
+    std::cout << "Ordered p-set: " << cnt << " configuration(s), prob: " << s.get() << std::endl;
+
+    return tab.confs_no() == cnt ? 0 : 1;
+}
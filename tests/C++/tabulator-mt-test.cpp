@@ -0,0 +1,91 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "isoSpec++.h"
+#include "tabulator.h"
+
+
+struct Row
+{
+    double lprob, mass, prob;
+    std::vector<int> conf;
+    bool operator<(const Row& other) const { return conf < other.conf; }
+    bool operator==(const Row& other) const
+    {
+        return lprob == other.lprob and mass == other.mass and prob == other.prob and conf == other.conf;
+    }
+};
+
+template<typename T> std::vector<Row> rows(Tabulator<T>& tab, int allDim)
+{
+    std::vector<Row> ret(tab.confs_no());
+    for(size_t ii=0; ii<tab.confs_no(); ii++)
+    {
+        ret[ii].lprob = tab.lprobs()[ii];
+        ret[ii].mass = tab.masses()[ii];
+        ret[ii].prob = tab.probs()[ii];
+        ret[ii].conf.resize(allDim);
+        tab.get_conf_signature(ii, ret[ii].conf.data());
+    }
+    return ret;
+}
+
+// The same configurations as the single-threaded tabulator, with the same masses
+// and probabilities (in another order), and in the same order whatever the number
+// of threads
+int compare(const char* formula, double threshold, bool absolute)
+{
+    std::vector<Row> ref;
+    int allDim;
+    {
+        IsoThresholdGenerator gen(Iso(formula), threshold, absolute);
+        Tabulator<IsoThresholdGenerator> tab(&gen, true, true, true, true);
+        allDim = gen.getAllDim();
+        ref = rows(tab, allDim);
+    }
+    std::sort(ref.begin(), ref.end());
+
+    std::vector<Row> first;
+    for(unsigned int threads : {1u, 2u, 3u, 8u, 0u})
+        for(bool compress : {false, true})
+        {
+            // A temporary Iso: the tabulator has to keep what it needs of it
+            ThresholdTabulatorMT tab(Iso(formula), threshold, absolute, threads, true, true, true, true, 1000, 1000, compress);
+            if(tab.confs_compressed() != compress or tab.confs_dim() != (compress ? Iso(formula).getDimNumber() : allDim))
+            {
+                std::cout << formula << ": wrong conf storage" << std::endl;
+                return 1;
+            }
+
+            std::vector<Row> got = rows(tab, allDim);
+            if(first.empty())
+                first = got;
+            else if(got != first)
+            {
+                std::cout << formula << ": order depends on the number of threads (" << threads << ")" << std::endl;
+                return 1;
+            }
+
+            std::sort(got.begin(), got.end());
+            if(got != ref)
+            {
+                std::cout << formula << ": differs with " << threads << " thread(s)" << (compress ? ", compressed" : "") << std::endl;
+                return 1;
+            }
+        }
+
+    std::cout << formula << ": " << ref.size() << " configuration(s) OK" << std::endl;
+    return 0;
+}
+
+int main()
+{
+    int failures = 0;
+
+    failures += compare("C100H202O30S2", 1e-7, true);
+    failures += compare("C520H817N139O147S8", 1e-6, false);
+    failures += compare("H2O", 1e-30, true);
+    failures += compare("C100", 2.0, true);     // nothing above the threshold
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+#include <iostream>
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include "marginalTrek++.h"
+#include "arena.h"
+
+
+const double masses[] = {12.0, 13.0033548378, 14.0031, 15.0001};
+const double probs[] = {0.97, 0.02, 0.007, 0.003};
+
+// Number of configurations of atomCnt atoms over isotopeNo isotopes
+size_t all_confs(int isotopeNo, int atomCnt)
+{
+    size_t res = 1;
+    for(int ii = 1; ii < isotopeNo; ii++)
+        res = res * (atomCnt + ii) / ii;
+    return res;
+}
+
+// PrecalculatedMarginal (which goes through all the configurations of tiny
+// marginals) against LayeredMarginal (which always searches): the same
+// configurations, with the same probabilities and masses, most probable first
+int compare(int isotopeNo, int atomCnt, double lCutOff)
+{
+    const size_t total = all_confs(isotopeNo, atomCnt);
+    MemoryAccounting accounting;
+    PrecalculatedMarginal pm(Marginal(masses, probs, isotopeNo, atomCnt, nullptr, &accounting), lCutOff, true, 1000, 1000);
+    LayeredMarginal lm(Marginal(masses, probs, isotopeNo, atomCnt), 1000, 1000);
+    lm.extend(lCutOff);
+
+    std::cout << isotopeNo << " isotope(s), " << atomCnt << " atom(s), " << total << " configuration(s) in total, cutoff "
+              << lCutOff << ": ";
+
+    if(pm.get_no_confs() != lm.get_no_confs() or (lCutOff == std::numeric_limits<double>::lowest() and pm.get_no_confs() != total))
+    {
+        std::cout << "wrong number of configurations" << std::endl;
+        return 1;
+    }
+
+    // Configurations of equal probability may come in either order
+    std::vector<bool> matched(lm.get_no_confs());
+    for(unsigned int ii = 0; ii < pm.get_no_confs(); ii++)
+    {
+        if(ii > 0 and pm.get_lProb(ii) > pm.get_lProb(ii-1))
+        {
+            std::cout << "configuration " << ii << " out of order" << std::endl;
+            return 1;
+        }
+        bool found = false;
+        for(unsigned int jj = 0; jj < lm.get_no_confs() and not found; jj++)
+            if(not matched[jj] and std::equal(pm.get_conf(ii), pm.get_conf(ii) + isotopeNo, lm.get_conf(jj)))
+            {
+                found = matched[jj] = pm.get_lProb(ii) == lm.get_lProb(jj) and pm.get_mass(ii) == lm.get_mass(jj)
+                                      and pm.get_eProb(ii) == exp(pm.get_lProb(ii));
+            }
+        if(not found)
+        {
+            std::cout << "configuration " << ii << " differs" << std::endl;
+            return 1;
+        }
+    }
+
+    // Tiny marginals keep all their configurations, and the scratch one, in a
+    // single page of exactly that size; the others in a page of tabSize
+    const size_t page = total <= TINY_MARGINAL_CONFS ? total + 1 : 1000;
+    if(accounting.used(MEMORY_CONF_PAGES) != page * isotopeNo * sizeof(int))
+    {
+        std::cout << "pages of " << accounting.used(MEMORY_CONF_PAGES) << " byte(s)" << std::endl;
+        return 1;
+    }
+
+    std::cout << pm.get_no_confs() << " configuration(s) OK" << std::endl;
+    return 0;
+}
+
+int main()
+{
+    int failures = 0;
+
+    const double cutoffs[] = {std::numeric_limits<double>::lowest(), -10.0, -2.0};
+    for(double lCutOff : cutoffs)
+    {
+        // 63, 64 and 65 configurations in total
+        for(int atomCnt = 62; atomCnt <= 64; atomCnt++)
+            failures += compare(2, atomCnt, lCutOff);
+        // 55 and 66, 56 and 84
+        failures += compare(3, 9, lCutOff);
+        failures += compare(3, 10, lCutOff);
+        failures += compare(4, 5, lCutOff);
+        failures += compare(4, 6, lCutOff);
+        // The smallest ones
+        failures += compare(1, 5, lCutOff);
+        failures += compare(2, 0, lCutOff);
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -1 +1,178 @@
 import IsoSpecPy as Iso
+import numpy as np
+
+
+def same_spectrum(a, b):
+    return sorted(zip(a.masses, a.probs)) == sorted(zip(b.masses, b.probs))
+
+def raises(exception, f, *args, **kwargs):
+    try:
+        f(*args, **kwargs)
+    except exception:
+        return True
+    return False
+
+
+def test_formula_parsing():
+    assert Iso.IsoParamsFromFormula("H2O")[:3] == (2, (2, 3), [2, 1])
+    assert Iso.IsoParamsFromFormula("CH3(CH2)2CH3")[2] == [4, 10]
+    assert Iso.IsoParamsFromFormula(" C6 H12 O6 ")[2] == [6, 12, 6]
+    assert Iso.IsoParamsFromFormula("Ca(OH)2")[2] == [1, 2, 2]
+
+def test_formula_groups():
+    # Groups are expanded, the same way as in IsoThresholdBatch
+    assert same_spectrum(Iso.IsoThreshold(formula="(CH2)3", threshold=1e-6), Iso.IsoThreshold(formula="C3H6", threshold=1e-6))
+    assert same_spectrum(Iso.IsoThreshold(formula="((CH2)2O)3H2", threshold=1e-6), Iso.IsoThreshold(formula="C6H14O3", threshold=1e-6))
+    batch = Iso.IsoThresholdBatch(1e-6, formulas=["(CH2)3"])
+    single = Iso.IsoThreshold(formula="(CH2)3", threshold=1e-6)
+    assert sorted(batch[0][0]) == sorted(single.masses)
+
+def test_invalid_formulas():
+    for formula in ["", "c6", "2C", "C(H", "CH)", "Xx", "H2O-"]:
+        assert raises(ValueError, Iso.IsoParamsFromFormula, formula), formula
+        assert raises(ValueError, Iso.IsoThreshold, formula=formula, threshold=1e-3), formula
+
+def test_isotope_labels():
+    Iso.RegisterIsotopeLabel("Heavy", "N", "15N=0.98")
+    assert Iso.LabelledProbs("N", "Heavy")[1] == 0.98
+    assert Iso.LabelledProbs("C", "13C=0.99")[1] == 0.99
+    assert raises(ValueError, Iso.RegisterIsotopeLabel, "1abc", "N", "15N=0.98")
+    assert raises(ValueError, Iso.LabelledProbs, "C", "13C=1.5")
+    assert raises(ValueError, Iso.LabelledProbs, "C", "Unknown")
+
+def test_batch_offsets():
+    formulas = ["H2O", "C100H202O30S2", "C6H12O6"] * 30
+    batch = Iso.IsoThresholdBatch(1e-5, formulas=formulas, absolute=True, get_confs=True, n_threads=4)
+    offsets = batch.np_offsets()
+    conf_offsets = batch.np_conf_offsets()
+    assert len(batch) == len(formulas) and offsets[0] == 0 and offsets[-1] == len(batch.np_masses())
+    for i, formula in enumerate(formulas):
+        single = Iso.IsoThreshold(formula=formula, threshold=1e-5, absolute=True)
+        masses, probs = batch[i]
+        assert sorted(zip(masses, probs)) == sorted(zip(single.masses, single.probs))
+        assert conf_offsets[i+1] - conf_offsets[i] == len(single) * sum(single.isotopeNumbers)
+    assert len(batch.np_confs()) == conf_offsets[-1]
+
+def test_batch_from_counts():
+    counts = [[n, 2*n+2] for n in range(1, 20)]
+    batch = Iso.IsoThresholdBatch(1e-4, elements=["C", "H"], atomCounts=counts)
+    for i, (c, h) in enumerate(counts):
+        single = Iso.IsoThreshold(formula="C%dH%d" % (c, h), threshold=1e-4)
+        assert np.allclose(sorted(batch[i][0]), sorted(single.masses))
+
+def test_batch_errors():
+    assert raises(ValueError, Iso.IsoThresholdBatch, 1e-3, formulas=["H2O", "C(H"])
+    assert raises(ValueError, Iso.IsoThresholdBatch, 1e-3, elements=["C", "Xx"], atomCounts=[[1, 1]])
+    assert raises(ValueError, Iso.IsoThresholdBatch, 1e-3, elements=["C", "H"], atomCounts=[[1, 1, 1]])
+    # Caught in C++, instead of terminating the process
+    assert raises(ValueError, Iso.IsoThresholdBatch, 1e-3, elements=["C", "C"], atomCounts=[[2**31-1, 5]])
+
+def test_iter_chunks():
+    # Chunks of a size that doesn't divide the number of configurations add up
+    # to what iterating one configuration at a time gives
+    for cls, kwargs in ((Iso.IsoThresholdGenerator, dict(threshold=1e-6)),
+                        (Iso.IsoLayeredGenerator, dict(delta=-3.0)),
+                        (Iso.IsoOrderedGenerator, dict())):
+        expected = list(cls(formula="C10H20O5S", get_confs=True, **kwargs))
+        chunks = list(cls(formula="C10H20O5S", get_confs=True, **kwargs).iter_chunks(7))
+        assert all(len(masses) == 7 for masses, _, _ in chunks[:-1]) and 0 < len(chunks[-1][0]) <= 7
+        masses = np.concatenate([c[0] for c in chunks])
+        lprobs = np.concatenate([c[1] for c in chunks])
+        confs = np.concatenate([c[2] for c in chunks])
+        assert list(masses) == [e[0] for e in expected]
+        assert list(lprobs) == [e[1] for e in expected]
+        assert [list(row) for row in confs] == [[n for isotope in e[2] for n in isotope] for e in expected]
+
+    # Without configurations, only masses and lprobs
+    gen = Iso.IsoThresholdGenerator(formula="C10H20O5S", threshold=1e-6)
+    chunks = list(gen.iter_chunks(1000))
+    assert len(chunks) == 1 and len(chunks[0]) == 2
+    single = Iso.IsoThreshold(formula="C10H20O5S", threshold=1e-6)
+    assert sorted(chunks[0][0]) == sorted(single.masses)
+    assert raises(NotImplementedError, list, gen.iter_chunks())
+
+def test_numpy_views():
+    import gc, weakref
+    for make in (lambda: Iso.IsoThreshold(formula="C100H202O30S2", threshold=1e-5, get_confs=True),
+                 lambda: Iso.IsoLayered(formula="C100H202O30S2", prob_to_cover=0.99, get_confs=True)):
+        result = make()
+        masses, lprobs, probs, confs = result.np_masses(), result.np_lprobs(), result.np_probs(), result.np_confs()
+        assert list(masses) == list(result.masses)
+        assert list(lprobs) == list(result.lprobs)
+        assert list(probs) == list(result.probs)
+        assert confs.shape == (len(result), sum(result.isotopeNumbers))
+        assert [list(row) for row in confs[:10]] == [[n for isotope in result.confs[i] for n in isotope] for i in range(10)]
+        assert not masses.flags.writeable
+        expected = list(masses)
+        # The views keep the results they were made from alive
+        collected = [False]
+        weakref.finalize(result, lambda: collected.__setitem__(0, True))
+        del result
+        gc.collect()
+        assert not collected[0]
+        assert list(masses) == expected and confs.sum() > 0
+        del masses, lprobs, probs, confs
+        gc.collect()
+        assert collected[0]
+
+    assert raises(ValueError, Iso.IsoThreshold(formula="H2O", threshold=1e-3).np_confs)
+    assert len(Iso.IsoThreshold(formula="H2O", threshold=2.0).np_masses()) == 0
+
+def test_threshold_mt():
+    single = Iso.IsoThreshold(formula="C520H817N139O147S8", threshold=1e-4, get_confs=True)
+    reference = None
+    for n_threads in (1, 2, 4, 0):
+        mt = Iso.IsoThresholdMT(formula="C520H817N139O147S8", threshold=1e-4, get_confs=True, n_threads=n_threads)
+        assert len(mt) == len(single)
+        assert sorted(zip(mt.masses, mt.lprobs, mt.confs)) == sorted(zip(single.masses, single.lprobs, single.confs))
+        # Nor does the order depend on the number of threads
+        rows = list(zip(mt.masses, mt.lprobs, mt.confs))
+        assert reference is None or rows == reference
+        reference = rows
+
+def test_binned_spectrum():
+    single = Iso.IsoThreshold(formula="C100H202O30S2", threshold=1e-5, absolute=True)
+    for n_threads in (1, 3):
+        spectrum = Iso.IsoBinnedSpectrum(formula="C100H202O30S2", threshold=1e-5, bucket_width=0.5, absolute=True, n_threads=n_threads)
+        assert spectrum.total_confs == len(single)
+        assert np.isclose(spectrum.np_probs().sum(), spectrum.total_prob)
+        assert np.isclose(spectrum.total_prob, sum(single.probs))
+        buckets = np.floor((single.np_masses() - spectrum.first_bucket_mass) / spectrum.bucket_width).astype(int)
+        assert np.allclose(np.bincount(buckets, weights=single.np_probs(), minlength=len(spectrum)), spectrum.np_probs())
+        assert len(spectrum.np_masses()) == len(spectrum)
+
+def test_memory_usage():
+    for cls, kwargs in ((Iso.IsoThresholdGenerator, dict(threshold=1e-6)),
+                        (Iso.IsoLayeredGenerator, dict()),
+                        (Iso.IsoOrderedGenerator, dict())):
+        gen = cls(formula="C100H202O30S2", **kwargs)
+        before = gen.memory_usage()
+        for i, _ in zip(range(5000), gen):
+            pass
+        after = gen.memory_usage()
+        for usage in (before, after):
+            assert set(usage) == set(Iso.IsoGenerator.memory_components)
+            assert usage["total"][0] > 0 and usage["iso"][0] > 0
+            assert all(peak >= used for used, peak in usage.values())
+            assert usage["total"][0] == sum(used for name, (used, peak) in usage.items() if name != "total")
+        assert all(after[name][1] >= before[name][1] for name in before)
+
+def test_huge_pages():
+    def results():
+        # The marginal tables of Sn14 are over HUGE_PAGE_BYTES, so they get mapped separately
+        threshold = Iso.IsoThreshold(formula="Sn14", threshold=1e-7, get_confs=True)
+        layered = Iso.IsoLayered(formula="C520H817N139O147S8", prob_to_cover=0.99)
+        spectrum = Iso.IsoBinnedSpectrum(formula="C520H817N139O147S8", threshold=1e-4, bucket_width=0.1, n_threads=2)
+        generator = Iso.IsoOrderedGenerator(formula="C520H817N139O147S8")
+        return (threshold.np_masses().tobytes(), threshold.np_lprobs().tobytes(), threshold.np_confs().tobytes(),
+                list(zip(layered.masses, layered.lprobs)),
+                (spectrum.first_bucket_mass, spectrum.np_probs().tobytes()),
+                [conf for _, conf in zip(range(1000), generator)],
+                generator.memory_usage()["total"][0] > 0)
+
+    expected = results()
+    Iso.SetHugePages(True)
+    try:
+        assert results() == expected
+    finally:
+        Iso.SetHugePages(False)